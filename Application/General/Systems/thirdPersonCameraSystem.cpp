@@ -5,9 +5,9 @@
 
 namespace Application::Systems {
 	namespace {
-		void recomputeCameraPosition(Saga::Transform* playerTransform, Saga::Camera* camera, 
+		void recomputeCameraPosition(const Saga::Transform* playerTransform, Saga::Camera* camera, 
 			ThirdPersonCamera* tpcamera, Saga::Transform* transform) {
-			glm::vec3 pos = playerTransform->transform->getPos() + tpcamera->shoulderOffset - camera->camera->getLook() * tpcamera->distance;
+			glm::vec3 pos = playerTransform->getPos() + tpcamera->shoulderOffset - camera->camera->getLook() * tpcamera->distance;
 			camera->camera->setPos(pos);
 		}
 	}
@@ -16,15 +16,13 @@ namespace Application::Systems {
 		for (auto &[entity, camera, tpcamera, transform] : 
 			*world->viewGroup<Saga::Camera, ThirdPersonCamera, Saga::Transform>()) {
 
-			if (tpcamera->playerToFollow) {
-				Saga::Transform &playerTransform = *tpcamera->playerToFollow;
+			if (const Saga::Transform* playerTransform = tpcamera->playerToFollow.get()) {
+				glm::vec3 currentPlayerPos = playerTransform->getPos();
 
-				glm::vec3 currentPlayerPos = playerTransform.transform->getPos();
+				if (currentPlayerPos != transform->getPos())
+					transform->setPos(currentPlayerPos);
 
-				if (currentPlayerPos != transform->transform->getPos())
-					transform->transform->setPos(currentPlayerPos);
-
-				recomputeCameraPosition(&playerTransform, camera, tpcamera, transform);
+				recomputeCameraPosition(playerTransform, camera, tpcamera, transform);
 				tpcamera->playerPreviousPosition = currentPlayerPos;
 			}
 		}
@@ -42,7 +40,7 @@ namespace Application::Systems {
 			glm::vec2 mousePos(xpos, ypos);
             std::optional<Saga::Entity> player = tpcamera->playerToFollow.getEntity();
             if (!player) continue;
-            auto playerInput = world->getComponent<PlayerInput>(player.value());
+            const PlayerInput* playerInput = world->getComponent<PlayerInput>(player.value()).get();
 
 			if (!tpcamera->isFirstFrame && playerInput && playerInput->mouseDown) {
 				glm::vec2 mouseDelta = mousePos - tpcamera->mousePosLastFrame;
@@ -56,9 +54,9 @@ namespace Application::Systems {
 
 				if (glm::dot(glm::normalize(camera->camera->getLook()), glm::vec3(0,-1,0)) > 0.8) {
 					camera->camera->rotate(-mouseDelta.y * tpcamera->turnRate.y, glm::vec3(look.z, 0, -look.x));
-				} else if (tpcamera->playerToFollow) {
-                    recomputeCameraPosition(tpcamera->playerToFollow, camera, tpcamera, transform);
-					if (camera->camera->getPos().y < tpcamera->playerToFollow->transform->getPos().y) {
+				} else if (const Saga::Transform* playerTransform = tpcamera->playerToFollow.get()) {
+                    recomputeCameraPosition(playerTransform, camera, tpcamera, transform);
+					if (camera->camera->getPos().y < playerTransform->getPos().y) {
 						camera->camera->rotate(-mouseDelta.y * tpcamera->turnRate.y, glm::vec3(look.z, 0, -look.x));
 						camera->camera->setPos(cachedCameraPos);
 					}
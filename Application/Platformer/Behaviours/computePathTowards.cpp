@@ -15,18 +15,18 @@ namespace Platformer {
         auto toPos = blackboard.get<glm::vec3>(targetKey);
         if (!toPos) return Saga::BehaviourTree::FAIL;
 
-        auto navMeshData = world->viewAll<Saga::NavMeshData>()->any();
+        Saga::NavMeshData* navMeshData = world->findResource<Saga::NavMeshData>();
         if (!navMeshData) return Saga::BehaviourTree::FAIL;
 
-        Saga::Transform* transform = world->getComponent<Saga::Transform>(blackboard.entity);
+        const Saga::Transform* transform = world->getComponent<Saga::Transform>(blackboard.entity).get();
         if (!transform) return Saga::BehaviourTree::FAIL;
 
         std::optional<Saga::NavMesh::Path> path = 
-            navMeshData.value()->findPath(transform->getPos(), toPos.value(), 0);
+            navMeshData->findPath(transform->getPos(), toPos.value(), 0);
 
         if (!path) return Saga::BehaviourTree::FAIL;
 
-        Saga::NavMesh::WalkablePath walkablePath = navMeshData.value()->tracePath(path.value());
+        Saga::NavMesh::WalkablePath walkablePath = navMeshData->tracePath(path.value());
 
         blackboard.put(pathKey, walkablePath);
         /* STRACE("computed path to player of length %f ending at %s", path->length, glm::to_string(path->to).c_str()); */
@@ -16,7 +16,7 @@ namespace Platformer {
         if (!playerController) return Saga::BehaviourTree::FAIL;
 
         Saga::Entity playerEntity = blackboard.world->getEntity(playerController.value());
-        Saga::Transform* transform = blackboard.world->getComponent<Saga::Transform>(playerEntity);
+        const Saga::Transform* transform = blackboard.world->getComponent<Saga::Transform>(playerEntity).get();
 
         if (!transform) return Saga::BehaviourTree::FAIL;
 
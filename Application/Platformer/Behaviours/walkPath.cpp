@@ -38,7 +38,7 @@ namespace Platformer {
         float walkAmt = std::clamp(blackboard.deltaTime * movementSpeed.value(), 0.0f, len);
 
         glm::vec3 nxtPos = curPos + dir * walkAmt;
-        transform->transform->setPos(nxtPos);
+        transform->setPos(nxtPos);
 
 
         return Saga::BehaviourTree::RUNNING;
@@ -6,8 +6,8 @@
 
 namespace Platformer::Systems {
 	void friendControllerSystem(std::shared_ptr<Saga::GameWorld> world, float deltaTime, float time) {
-		for (auto &[entity, controller, rigidbody, transform] : 
-            *world->viewGroup<FriendController, Saga::RigidBody, Saga::Transform>()) {
+		world->parallelEach<FriendController, Saga::RigidBody, Saga::Transform>(
+            [&](Saga::Entity, FriendController* controller, Saga::RigidBody* rigidbody, Saga::Transform* transform) {
 
 			// apply gravity
 			rigidbody->velocity.y -= deltaTime * controller->gravity;
@@ -23,7 +23,7 @@ namespace Platformer::Systems {
 
             // combined vertical, inward, and tangent speed
             rigidbody->velocity = rigidbody->velocity.y * glm::vec3(0,1,0) + inward + tangent;
-        }
+        });
     }
 
 	void registerFriendControllerSystem(std::shared_ptr<Saga::GameWorld> world) {
@@ -15,6 +15,7 @@ namespace Platformer::Systems {
 
 	void playerControllerSystem(std::shared_ptr<Saga::GameWorld> world, float deltaTime, float time) {
 		Saga::Camera& mainCamera = *world->viewAll<Saga::Camera>()->begin();
+		// kept serial: the ground check walks the colliders of every other entity, and there is usually a single player anyway
 		for (auto &[entity, controller, input, rigidbody, transform] : *world->viewGroup<PlayerController, Application::PlayerInput, Saga::RigidBody, Saga::Transform>()) {
 			glm::vec3 moveAmount(0,0,0);
 
@@ -30,7 +31,7 @@ namespace Platformer::Systems {
 			rigidbody->velocity.x = horizontalVelocity.x;
 			rigidbody->velocity.z = horizontalVelocity.z;
 
-			glm::vec3 groundPos = transform->transform->getScale() * 0.5f * glm::vec3(0,-1,0) + transform->transform->getPos();
+			glm::vec3 groundPos = transform->getScale() * 0.5f * glm::vec3(0,-1,0) + transform->getPos();
 
 			float depthOfGroundCast = 0.01f;
 			float skinWidth = 0.01f;
@@ -13,11 +13,10 @@ namespace Platformer::Systems {
 void simpleTestAISystem(std::shared_ptr<Saga::GameWorld> world, float deltaTime, float time) {
     for (auto& [entity, testAI, transform] : *world->viewGroup<SimpleTestAI, Saga::Transform>()) {
         if (!testAI->path) {
-            auto navMeshes = world->viewAll<Saga::NavMeshData>();
-            if (navMeshes->size()) {
-                Saga::NavMeshData& navMesh = *navMeshes->begin();
-                std::optional<Saga::NavMesh::Path> optionalPath = navMesh.findPath(transform->getPos(), glm::vec3(0,0,0), 1.f);
-                if (optionalPath) testAI->path = navMesh.tracePath(optionalPath.value());
+            Saga::NavMeshData* navMesh = world->findResource<Saga::NavMeshData>();
+            if (navMesh) {
+                std::optional<Saga::NavMesh::Path> optionalPath = navMesh->findPath(transform->getPos(), glm::vec3(0,0,0), 1.f);
+                if (optionalPath) testAI->path = navMesh->tracePath(optionalPath.value());
             }
         }
         glm::vec3 curPos = transform->getPos() - glm::vec3(0,.5,0);
@@ -34,7 +33,7 @@ void simpleTestAISystem(std::shared_ptr<Saga::GameWorld> world, float deltaTime,
             /* SDEBUG("direction: %s; amt: %f", glm::to_string(dir).c_str(), walkAmt); */
 
             glm::vec3 nxtPos = curPos + dir * walkAmt;
-            transform->transform->setPos(nxtPos + glm::vec3(0,.5,0));
+            transform->setPos(nxtPos + glm::vec3(0,.5,0));
         }
     }
 }
@@ -76,7 +76,7 @@ namespace Platformer {
 			Saga::Material& mat = *mainWorld->emplace<Saga::Material>(plane,
 				Saga::Theme_Nostalgic::colors[1]);
             Saga::Transform* transform = mainWorld->emplace<Saga::Transform>(plane);
-            transform->transform->setPos(pos);
+            transform->setPos(pos);
 
 			mainWorld->emplace<Saga::Collider>(plane);
 			mainWorld->emplace<Saga::MeshCollider>(plane);
@@ -92,7 +92,7 @@ namespace Platformer {
                 glm::vec3(0.5, 0.5, 1) // light color
             );
 			Saga::Transform& transform = *mainWorld->emplace<Saga::Transform>(lightEnt);
-            transform.transform->setPos(glm::vec3(0,3,0));
+            transform.setPos(glm::vec3(0,3,0));
 			return lightEnt;
 		};
 
@@ -108,7 +108,7 @@ namespace Platformer {
             mainWorld->emplace<Saga::CylinderCollider>(player, 1, 0.5);
 
 			Saga::Transform* transform = mainWorld->emplace<Saga::Transform>(player);
-			transform->transform->setPos(glm::vec3(0,10,5));
+			transform->setPos(glm::vec3(0,10,5));
 			return player;
 		};
 
@@ -134,7 +134,7 @@ namespace Platformer {
             spawnPos.y = 5;
 
 			Saga::Transform* transform = mainWorld->emplace<Saga::Transform>(fr);
-			transform->transform->setPos(spawnPos);
+			transform->setPos(spawnPos);
 			return fr;
 
         };
@@ -147,9 +147,9 @@ namespace Platformer {
 		};
 
         auto setupNavMesh = [this]() {
-            auto navmesh = mainWorld->emplace<Saga::NavMeshData>(mainWorld->getMasterEntity());
-            navmesh->buildFromFile("Resources/Meshes/environment3nav.obj");
-            /* mainWorld->emplace<Saga::Transform>(navMeshContainer)->transform->setPos(glm::vec3(0,0.1,0)); */
+            auto& navmesh = mainWorld->emplaceResource<Saga::NavMeshData>();
+            navmesh.buildFromFile("Resources/Meshes/environment3nav.obj");
+            /* mainWorld->emplace<Saga::Transform>(navMeshContainer)->setPos(glm::vec3(0,0.1,0)); */
             /* mainWorld->emplace<Saga::Mesh>(navMeshContainer, "Resources/Meshes/environment3nav.obj"); */
             /* mainWorld->emplace<Saga::Material>(navMeshContainer, glm::vec3(0,0,0.5)); */
         };
@@ -191,7 +191,11 @@ namespace Platformer {
 	void App::setupSystems() {
 		Saga::Systems::registerDrawSystem(mainWorld);
 		Saga::Systems::registerCollisionSystem(mainWorld);
-        Saga::Systems::registerAISystems(mainWorld);
+        // the behaviour nodes used by friends look up the player, the navmesh, and move their own transform
+        Saga::Systems::registerAISystems(mainWorld, Saga::SystemAccess()
+            .read<Platformer::PlayerController>()
+            .readResource<Saga::NavMeshData>()
+            .write<Saga::Transform>());
         Saga::Systems::registerParticleSystem(mainWorld);
 		Platformer::Systems::registerPlayerControllerSystem(mainWorld);
         Platformer::Systems::registerSimpleTestAISystem(mainWorld);
@@ -227,7 +231,7 @@ namespace Platformer {
 			mainWorld->emplace<Saga::Mesh>(fr, Saga::Mesh::StandardType::Sphere);
 
 			Saga::Transform* transform = mainWorld->emplace<Saga::Transform>(fr);
-			transform->transform->setPos(pos + glm::vec3(0,0.5f,0));
+			transform->setPos(pos + glm::vec3(0,0.5f,0));
 
             Saga::BehaviourTree* behaviourTree = mainWorld->emplace<Saga::BehaviourTree>(fr);
             behaviourTree
@@ -247,12 +251,9 @@ namespace Platformer {
         ImGui::Begin("Friend Creation Tool", NULL, ImGuiWindowFlags_MenuBar);
         if (ImGui::Button("Spawn Random Friend")) {
             // chooses a random point on the navmesh
-            for (auto navData : *mainWorld->viewAll<Saga::NavMeshData>()) {
-                std::optional<glm::vec3> spawnPos = navData.getRandomPosition();
-                if (spawnPos) {
-                    setupFriend(spawnPos.value());
-                    break; // we only spawn it on the first navmesh
-                }
+            if (Saga::NavMeshData* navData = mainWorld->findResource<Saga::NavMeshData>()) {
+                std::optional<glm::vec3> spawnPos = navData->getRandomPosition();
+                if (spawnPos) setupFriend(spawnPos.value());
             }
         }
         ImGui::End();
@@ -99,10 +99,9 @@ void playerController(std::shared_ptr<Saga::GameWorld> world, float deltaTime, f
     auto mainCamera = world->viewAll<Saga::Camera>()->any();
     if (!mainCamera) return;
 
-    auto group = *world->viewGroup<Star::Player, Star::PlayerInput, Saga::RigidBody, Saga::Transform>();
-
     // horizontal movement
-    for (auto &[entity, player, playerInput, rigidBody, transform] : group) {
+    world->parallelEach<Star::Player, Star::PlayerInput, Saga::RigidBody, Saga::Transform>(
+        [&](Saga::Entity, Star::Player* player, Star::PlayerInput* playerInput, Saga::RigidBody* rigidBody, Saga::Transform*) {
         glm::vec3 look = mainCamera.value()->camera->getLook();
         glm::vec2 movement = playerInput->movement();
 
@@ -116,7 +115,7 @@ void playerController(std::shared_ptr<Saga::GameWorld> world, float deltaTime, f
         glm::vec3 velocityDiff = desiredVelocity - currentVelocity;
 
         glm::vec3 accelerationDir = desiredVelocity - currentVelocity;
-        if (!glm::length2(accelerationDir)) continue;
+        if (!glm::length2(accelerationDir)) return;
 
         accelerationDir = glm::normalize(accelerationDir);
         glm::vec3 frameAcceleration = accelerationDir * deltaTime * player->accelerationSpeed();
@@ -127,15 +126,15 @@ void playerController(std::shared_ptr<Saga::GameWorld> world, float deltaTime, f
         rigidBody->velocity += frameAcceleration;
         /* rigidBody->velocity.x = desiredVelocity.x; */
         /* rigidBody->velocity.z = desiredVelocity.z; */
-    }
+    });
 
-    auto group2 = *world->viewGroup<Saga::EllipsoidCollider, Star::Player, Star::PlayerInput,
+    auto &group2 = *world->viewGroup<Saga::EllipsoidCollider, Star::Player, Star::PlayerInput,
          Saga::RigidBody, Saga::Transform>();
 
     // jump + gravity
     for (auto &[entity, ellipsoidCollider, player, playerInput, rigidBody, transform] : group2) {
         if (transform->getPos().y < player->minY)
-            transform->transform->setPos(glm::vec3(0,player->maxY,10));
+            transform->setPos(glm::vec3(0,player->maxY,10));
 
         float raycastDepth = 0.05f;
         float skinWidth = 0.001f;
@@ -169,7 +168,7 @@ void playerController(std::shared_ptr<Saga::GameWorld> world, float deltaTime, f
 }
 
 void cameraControllerScroll(std::shared_ptr<Saga::GameWorld> world, double xpos, double ypos) {
-    auto group = *world->viewGroup<Saga::Camera, Star::Camera, Star::PlayerInput, Saga::Transform>();
+    auto &group = *world->viewGroup<Saga::Camera, Star::Camera, Star::PlayerInput, Saga::Transform>();
     for (auto &[entity, camera, cameraController, playerInput, transform] : group) {
         glm::vec2 mousePos(xpos, ypos);
 
@@ -205,7 +204,7 @@ void cameraControllerScroll(std::shared_ptr<Saga::GameWorld> world, double xpos,
 }
 
 void cameraControllerUpdate(std::shared_ptr<Saga::GameWorld> world, float deltaTime, float time) {
-    auto group = *world->viewGroup<Saga::Camera, Star::Camera, Saga::Transform>();
+    auto &group = *world->viewGroup<Saga::Camera, Star::Camera, Saga::Transform>();
     for (auto &[entity, camera, cameraController, transform] : group) {
         cameraController->realDistance = Saga::Math::damp(cameraController->realDistance, 
             cameraController->distance, cameraController->distanceSmoothing, deltaTime);
@@ -215,7 +214,7 @@ void cameraControllerUpdate(std::shared_ptr<Saga::GameWorld> world, float deltaT
 
         camera->camera->setPos(pos);
 
-        auto drawSystemData = world->getComponent<Saga::DrawSystemData>(world->getMasterEntity());
+        auto drawSystemData = world->findResource<Saga::DrawSystemData>();
         if (drawSystemData)
             drawSystemData->postProcessingSettings.focusDistance = cameraController->distance;
     }
@@ -6,22 +6,22 @@
 #include "Engine/Components/collider.h"
 #include "Engine/Components/mesh.h"
 #include "Engine/Components/transform.h"
+#include "Engine/MetaSystems/hierarchy.h"
 
 namespace Star::Systems {
 
 void starCollect(std::shared_ptr<Saga::GameWorld> world, Saga::Entity entity, Saga::Entity other) {
     world->destroyEntity(entity);
 
-    auto comet = world->getComponent<Comet>(entity);
-    auto transform = world->getComponent<Saga::Transform>(entity);
-    if (!comet || !transform) return;
+    const Comet* comet = world->getComponent<Comet>(entity).get();
+    if (!comet) return;
 
     auto particleEmitter = world->getComponent<Saga::ParticleEmitter>(comet->effect);
-    auto particleTransform = world->getComponent<Saga::Transform>(comet->effect);
-    if (!particleTransform || !particleEmitter) return;
+    if (!particleEmitter) return;
 
+    // the effect outlives the star, so it stays where the star was
+    Saga::Hierarchy::detach(world, comet->effect);
     particleEmitter->play();
-    particleTransform->transform->setPos(transform->getPos());
     Saga::AudioEngine::playEvent(FMODSettings::starCollect);
 }
 
@@ -41,13 +41,13 @@ void playerGrowth(std::shared_ptr<Saga::GameWorld> world, Saga::Entity player, S
 
     playerInfo->growthValue = std::pow(playerInfo->growthFactor, playerInfo->starsCollected.size());
 
-    glm::vec3 prevScale = transform->transform->getScale();
+    glm::vec3 prevScale = transform->getScale();
     glm::vec3 currentScale = glm::vec3(playerInfo->growthValue);
 
     camera->distance *= playerInfo->growthFactor;
     // push upward so we don't end up inside terrain
-    transform->transform->setPos(transform->getPos() + (currentScale.y - prevScale.y) * glm::vec3(0,1,0));
-    transform->transform->setScale(currentScale);
+    transform->setPos(transform->getPos() + (currentScale.y - prevScale.y) * glm::vec3(0,1,0));
+    transform->setScale(currentScale);
 
     ellipsoidCollider->radius = currentScale / 2.0f;
     cylinderCollider->radius = currentScale.x/2.0f;
@@ -59,8 +59,8 @@ void playerGrowth(std::shared_ptr<Saga::GameWorld> world, Saga::Entity player, S
 void animateStar(std::shared_ptr<Saga::GameWorld> world, float deltaTime, float time) {
     for (auto& [entity, comet, transform] : *world->viewGroup<Star::Comet, Saga::Transform>()) {
         glm::vec3 position = comet->initialPos + std::sin(comet->boppingSpeed * time) * comet->boppingDistance * glm::vec3(0,1,0);
-        transform->transform->setPos(position);
-        transform->transform->rotate(deltaTime * comet->rotationSpeed, glm::vec3(0,1,0));
+        transform->setPos(position);
+        transform->rotate(deltaTime * comet->rotationSpeed, glm::vec3(0,1,0));
     }
 }
 
@@ -51,7 +51,7 @@ Saga::Entity createPlayer(std::shared_ptr<Saga::GameWorld> world, glm::vec3 pos)
         .shader = "phong"
     });
 
-    world->emplace<Saga::Transform>(entity)->transform->setPos(pos);
+    world->emplace<Saga::Transform>(entity)->setPos(pos);
 
     world->emplace<Saga::Collider>(entity);
     world->emplace<Saga::CylinderCollider>(entity, 1, 0.5);
@@ -8,67 +8,93 @@
 #include "Engine/Components/material.h"
 #include "Engine/Components/mesh.h"
 #include "Engine/Components/transform.h"
+#include "Engine/Gameworld/prefab.h"
+#include "Engine/MetaSystems/hierarchy.h"
 #include "Engine/Systems/events.h"
 
 namespace Star {
 
+namespace {
+    /**
+     * @brief What every star and its collection effect start out with, captured the first time a star is created in a world.
+     * The mesh, material, shader and texture are loaded once, and shared by every star.
+     */
+    struct StarPrefabs {
+        Saga::Prefab star;
+        Saga::Prefab effect;
+    };
+
+    StarPrefabs& getPrefabs(std::shared_ptr<Saga::GameWorld> world) {
+        if (StarPrefabs* prefabs = world->findResource<StarPrefabs>()) return *prefabs;
+        StarPrefabs& prefabs = world->emplaceResource<StarPrefabs>();
+
+        prefabs.star.emplace<Saga::Mesh>("Resources/Meshes/star.obj");
+        /* prefabs.star.emplace<Saga::Mesh>(Saga::Mesh::StandardType::Sphere); */
+        glm::vec3 starColor = palette.getColor(starColorIndex);
+
+        prefabs.star.emplace<Saga::Material>(starColor)->material
+            ->setEmission(starColor * 1.0f);
+        prefabs.star.emplace<Saga::Transform>()->setScale(0.5);
+
+        prefabs.star.emplace<Saga::Collider>();
+        prefabs.star.emplace<Saga::CylinderCollider>(1, 0.5); // height, radius
+
+        prefabs.star.emplace<Star::Comet>(Comet {
+            .rotationSpeed = 3,
+            .boppingSpeed = 2,
+            .boppingDistance = 1,
+        });
+
+        // effect
+        GraphicsEngine::Global::graphics.addShader("starCollection",
+        {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER},
+        {"Resources/Shaders/particles/vertex.vert", "Resources/Shaders/particles/particleTextured.frag"});
+
+        std::shared_ptr<GraphicsEngine::Shader> shader = GraphicsEngine::Global::graphics.getShader("starCollection");
+
+        std::shared_ptr<GraphicsEngine::Texture> starTexture = std::make_shared<GraphicsEngine::Texture>(
+            "Resources/Images/particles/starOutline.png");
+
+        prefabs.effect.emplace<Saga::ParticleCollection>(
+                100,
+                Saga::ParticleCollection::BlendMode::ADDITIVE,
+                shader, starTexture);
+
+        Saga::ParticleEmitter* emitter = prefabs.effect.emplace<Saga::ParticleEmitter>();
+        emitter->burst = 30;
+        emitter->emissionRate = 0;
+        emitter->particleTemplate = Saga::ParticleTemplate {
+            .position = glm::vec3(0,0,0),
+            .velocity = glm::vec3(0, 2, 0),
+            .velocityRandomness = glm::vec3(1, 1, 1) * 40.f,
+            .gravity = 1,
+            .color = glm::vec4(starColor * 3.0f,1),
+            .size = 1,
+            .sizeVariation = 0.5,
+            .rotation = 0.0f,
+            .lifetime = 5.0f
+        };
+
+        prefabs.effect.emplace<Saga::Transform>();
+        return prefabs;
+    }
+}
+
 Saga::Entity createStar(std::shared_ptr<Saga::GameWorld> world, glm::vec3 pos) {
-    Saga::Entity entity = world->createEntity();
-    Saga::Entity effect = world->createEntity();
-
-    world->emplace<Saga::Mesh>(entity, "Resources/Meshes/star.obj");
-    /* world->emplace<Saga::Mesh>(entity, Saga::Mesh::StandardType::Sphere); */
-    glm::vec3 starColor = palette.getColor(starColorIndex);
-
-    world->emplace<Saga::Material>(entity, starColor)->material
-        ->setEmission(starColor * 1.0f);
-    world->emplace<Saga::Transform>(entity)->transform->setPos(pos)->setScale(0.5);
-
-    world->emplace<Saga::Collider>(entity);
-    world->emplace<Saga::CylinderCollider>(entity, 1, 0.5); // height, radius
-
-    world->emplace<Star::Comet>(entity, Comet {
-        .initialPos = pos,
-        .rotationSpeed = 3,
-        .boppingSpeed = 2,
-        .boppingDistance = 1,
-        .effect = effect
-    });
+    StarPrefabs& prefabs = getPrefabs(world);
+    Saga::Entity entity = prefabs.star.instantiate(world);
+    Saga::Entity effect = prefabs.effect.instantiate(world);
+
+    world->getComponent<Saga::Transform>(entity)->setPos(pos);
+    Star::Comet* comet = world->getComponent<Star::Comet>(entity);
+    comet->initialPos = pos;
+    comet->effect = effect;
+
     world->getSystems().addEventSystem(Saga::EngineEvents::OnCollision, entity,
         Saga::System<Saga::Entity, Saga::Entity>(Star::Systems::starCollect));
 
-    // effect
-    GraphicsEngine::Global::graphics.addShader("starCollection",
-    {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER},
-    {"Resources/Shaders/particles/vertex.vert", "Resources/Shaders/particles/particleTextured.frag"});
-
-    std::shared_ptr<GraphicsEngine::Shader> shader = GraphicsEngine::Global::graphics.getShader("starCollection");
-
-    std::shared_ptr<GraphicsEngine::Texture> starTexture = std::make_shared<GraphicsEngine::Texture>(
-        "Resources/Images/particles/starOutline.png");
-
-    world->emplace<Saga::ParticleCollection>(effect,
-            100,
-            Saga::ParticleCollection::BlendMode::ADDITIVE,
-            shader, starTexture);
-
-    Saga::ParticleEmitter emitter = Saga::ParticleEmitter();
-    emitter.burst = 30;
-    emitter.emissionRate = 0;
-    emitter.particleTemplate = Saga::ParticleTemplate {
-        .position = glm::vec3(0,0,0),
-        .velocity = glm::vec3(0, 2, 0),
-        .velocityRandomness = glm::vec3(1, 1, 1) * 40.f,
-        .gravity = 1,
-        .color = glm::vec4(starColor * 3.0f,1),
-        .size = 1,
-        .sizeVariation = 0.5,
-        .rotation = 0.0f,
-        .lifetime = 5.0f
-    };
-
-    world->emplace<Saga::ParticleEmitter>(effect, emitter);
-    world->emplace<Saga::Transform>(effect);
+    // the effect rides along with the star until it is collected
+    Saga::Hierarchy::setParent(world, effect, entity);
 
     return entity;
 }
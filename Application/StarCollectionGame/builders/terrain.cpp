@@ -4,6 +4,7 @@
 #include "Engine/Components/material.h"
 #include "Engine/Components/mesh.h"
 #include "Engine/Components/transform.h"
+#include "Engine/Gameworld/prefab.h"
 
 namespace Star {
 
@@ -12,22 +13,37 @@ Saga::Entity createMainStage(std::shared_ptr<Saga::GameWorld> world, glm::vec3 p
     glm::vec3 terrainColor = palette.getColor(terrainColorIndex);
     world->emplace<Saga::Mesh>(entity, "Resources/Meshes/arena.obj");
     world->emplace<Saga::Material>(entity, terrainColor, 0);
-    world->emplace<Saga::Transform>(entity)->transform->setPos(pos);
+    world->emplace<Saga::Transform>(entity)->setPos(pos);
 
     world->emplace<Saga::Collider>(entity);
     world->emplace<Saga::MeshCollider>(entity);
     return entity;
 }
 
+namespace {
+    /**
+     * @brief What every sub stage starts out with, captured the first time one is created in a world, so that its mesh is only loaded once.
+     */
+    struct SubStagePrefab {
+        Saga::Prefab prefab;
+    };
+}
+
 Saga::Entity createSubStage(std::shared_ptr<Saga::GameWorld> world, glm::vec3 pos) {
-    Saga::Entity entity = world->createEntity();
-    glm::vec3 terrainColor = palette.getColor(terrainColorIndex);
-    world->emplace<Saga::Mesh>(entity, "Resources/Meshes/arena_rock.obj");
-    world->emplace<Saga::Material>(entity, terrainColor, 0);
-    world->emplace<Saga::Transform>(entity)->transform->setPos(pos);
+    SubStagePrefab* subStage = world->findResource<SubStagePrefab>();
+    if (!subStage) {
+        subStage = &world->emplaceResource<SubStagePrefab>();
+        glm::vec3 terrainColor = palette.getColor(terrainColorIndex);
+        subStage->prefab.emplace<Saga::Mesh>("Resources/Meshes/arena_rock.obj");
+        subStage->prefab.emplace<Saga::Material>(terrainColor, 0);
+        subStage->prefab.emplace<Saga::Transform>();
 
-    world->emplace<Saga::Collider>(entity);
-    world->emplace<Saga::MeshCollider>(entity);
+        subStage->prefab.emplace<Saga::Collider>();
+        subStage->prefab.emplace<Saga::MeshCollider>();
+    }
+
+    Saga::Entity entity = subStage->prefab.instantiate(world);
+    world->getComponent<Saga::Transform>(entity)->setPos(pos);
     return entity;
 }
 
@@ -32,7 +32,7 @@ StarApp::~StarApp() {
 
 void StarApp::worldSetup() {
     mainWorld = createGameWorld();
-    mainWorld->emplace<Saga::DrawSystemData>(mainWorld->getMasterEntity())->postProcessingSettings.fogColor = 
+    mainWorld->emplaceResource<Saga::DrawSystemData>().postProcessingSettings.fogColor = 
         palette.getColor(fogColorIndex);
 
     // system setups
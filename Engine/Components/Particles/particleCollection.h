@@ -152,7 +152,7 @@ private:
 
 
     // declare the friend systems so they can use the class's private variables.
-    friend void Systems::particleSystemSimulationUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+    friend void Systems::particleSystemSimulationUpdate(WorldRef world, float deltaTime, float time);
     friend void Systems::particleSystemOnRender(std::shared_ptr<GameWorld> world, Saga::Camera& camera);
 };
 
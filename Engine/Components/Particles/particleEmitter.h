@@ -30,7 +30,7 @@ private:
     bool playing = 0;
     bool shouldBurst = 0;
 
-    friend void Systems::particleSystemEmissionUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+    friend void Systems::particleSystemEmissionUpdate(WorldRef world, float deltaTime, float time);
 };
 
 }
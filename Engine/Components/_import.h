@@ -10,4 +10,5 @@
 #include "rigidbody.h"
 #include "transform.h"
 #include "light.h"
-#include "audioemitter.h"
\ No newline at end of file
+#include "audioemitter.h"
+#include "hierarchy.h"
\ No newline at end of file
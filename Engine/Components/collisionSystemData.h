@@ -2,6 +2,8 @@
 
 #include "Engine/Datastructures/Accelerant/bvh.h"
 #include "Engine/Datastructures/Accelerant/uniformGrid.h"
+#include <utility>
+#include <vector>
 
 namespace Saga {
 
@@ -14,6 +16,9 @@ namespace Saga {
 struct CollisionSystemData {
     std::optional<BoundingVolumeHierarchy> bvh; //!< the bounding volume hierarchy of triangles of static objectts.
     std::optional<UniformGrid<Entity>> uniformGrid; //!< the uniform grids used in optimizing dynamic-dynamic collisions.
+
+    std::vector<std::pair<Entity, Entity>> contacts; //!< pairs that collided during the current step, smaller entity first. May hold duplicates until dispatched.
+    std::vector<std::pair<Entity, Entity>> lastContacts; //!< sorted, unique pairs that collided during the previous step.
 };
 
 }
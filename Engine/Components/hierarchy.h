@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Engine/Entity/entity.h"
+#include <vector>
+
+namespace Saga {
+
+struct Transform;
+
+/**
+ * @brief The entity this entity is attached to. Its Transform is relative to the parent's Transform.
+ * Use Saga::Hierarchy to attach and detach entities, which keeps Parent and Children in sync.
+ * @ingroup component
+ */
+struct Parent {
+	Entity entity; //!< the parent.
+};
+
+/**
+ * @brief The entities attached to this entity. See Parent.
+ * @ingroup component
+ */
+struct Children {
+	std::vector<Entity> entities; //!< the children, in the order they were attached.
+};
+
+/**
+ * @brief Resource of a world, holding every attached Transform sorted breadth-first, so that world matrices propagate in one linear pass:
+ * each parent comes before its children. This is rebuilt only when the hierarchy changes, or when Transforms move inside their container.
+ */
+struct TransformHierarchy {
+	/**
+	 * @brief An attached Transform, and the Transform it is relative to.
+	 */
+	struct Link {
+		Transform* child;
+		const Transform* parent; //!< null if the parent has no Transform, or no longer exists. The child is then relative to the world.
+	};
+
+	std::vector<Link> links; //!< attached Transforms, breadth-first. Pointers stay valid until the Transform container reorders.
+	bool outdated = true; //!< whether entities were attached or detached since links was built.
+	int lastReordered[3] = {-1, -1, -1}; //!< getLastReordered() of the Transform, Parent and Children containers when links was built.
+};
+
+} // namespace Saga
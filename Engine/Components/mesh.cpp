@@ -22,39 +22,41 @@ Mesh::Mesh(StandardType type) : attributes(attr::POS | attr::NORM | attr::UV), v
 
 	mesh = GraphicsEngine::Global::graphics.getShape(shapeName);
 
-	if (type == StandardType::Quad) 		data = GraphicsEngine::quadVertexBufferData;
-	if (type == StandardType::Cylinder) 	data = GraphicsEngine::cylinderVertexBufferData;
-	if (type == StandardType::Cone) 		data = GraphicsEngine::coneVertexBufferData;
-	if (type == StandardType::Sphere) 		data = GraphicsEngine::sphereVertexBufferData;	
-	if (type == StandardType::Cube) 		data = GraphicsEngine::cubeVertexBufferData;
+	if (type == StandardType::Quad) 		data = std::make_shared<const std::vector<float>>(GraphicsEngine::quadVertexBufferData);
+	if (type == StandardType::Cylinder) 	data = std::make_shared<const std::vector<float>>(GraphicsEngine::cylinderVertexBufferData);
+	if (type == StandardType::Cone) 		data = std::make_shared<const std::vector<float>>(GraphicsEngine::coneVertexBufferData);
+	if (type == StandardType::Sphere) 		data = std::make_shared<const std::vector<float>>(GraphicsEngine::sphereVertexBufferData);	
+	if (type == StandardType::Cube) 		data = std::make_shared<const std::vector<float>>(GraphicsEngine::cubeVertexBufferData);
 
-	if (data.size() % vertexRange) 
-		SERROR("Loaded a mesh of standard type %d but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", type, data.size(), vertexRange);
+	if (data->size() % vertexRange) 
+		SERROR("Loaded a mesh of standard type %d but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", type, data->size(), vertexRange);
 }
 
 Mesh::Mesh(const std::string &filepath) : attributes(attr::POS | attr::NORM), vertexRange(getVertexRange(attributes)) {
-	data = GraphicsEngine::Global::graphics.getObjData(filepath);
-    mesh = GraphicsEngine::Global::graphics.addShape("@saga_shape::" + std::to_string(++id_value()), data, attributes);
+	data = std::make_shared<const std::vector<float>>(GraphicsEngine::Global::graphics.getObjData(filepath));
+    mesh = GraphicsEngine::Global::graphics.addShape("@saga_shape::" + std::to_string(++id_value()), *data, attributes);
 
-	if (data.size() % vertexRange) 
-        SERROR("Loaded a mesh from file '%s' but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", filepath.c_str(), data.size(), vertexRange);
+	if (data->size() % vertexRange) 
+        SERROR("Loaded a mesh from file '%s' but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", filepath.c_str(), data->size(), vertexRange);
 }
 
-Mesh::Mesh(std::vector<float> data, GraphicsEngine::VAOAttrib attributes) : data(data), attributes(attributes), vertexRange(getVertexRange(attributes)) {
+Mesh::Mesh(std::vector<float> data, GraphicsEngine::VAOAttrib attributes) : attributes(attributes), vertexRange(getVertexRange(attributes)) {
     mesh = GraphicsEngine::Global::graphics.addShape("@saga_shape::" + std::to_string(++id_value()), data, attributes);
+	this->data = std::make_shared<const std::vector<float>>(std::move(data));
 
-	if (data.size() % vertexRange) 
-		SERROR("Loaded a mesh from data but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", data.size(), vertexRange);
+	if (this->data->size() % vertexRange) 
+		SERROR("Loaded a mesh from data but the data size (%d) is not divisible by number of floats (%d) required to store a vertex.", this->data->size(), vertexRange);
 }
 
 glm::vec3 Mesh::getPos(int index) {
-	SASSERT_MESSAGE(index >= 0 && index * vertexRange < data.size(), "Index cannot be below 0 or above tri count.");
-	glm::vec3 pos(data[index*vertexRange + 0], data[index*vertexRange + 1], data[index*vertexRange + 2]);
+	SASSERT_MESSAGE(data && index >= 0 && index * vertexRange < data->size(), "Index cannot be below 0 or above tri count.");
+	const std::vector<float>& vertices = *data;
+	glm::vec3 pos(vertices[index*vertexRange + 0], vertices[index*vertexRange + 1], vertices[index*vertexRange + 2]);
 	return pos;
 }
 
 int Mesh::getTrianglesCnt() {
-	return data.size() / vertexRange / 3;
+	return data ? data->size() / vertexRange / 3 : 0;
 }
 
 int Mesh::getVertexRange(GraphicsEngine::VAOAttrib attributes) {
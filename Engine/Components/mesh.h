@@ -26,7 +26,7 @@ struct Mesh {
 	};
 
 	std::shared_ptr<GraphicsEngine::Shape> mesh;
-	std::vector<float> data; //!< packed vertex data 
+	std::shared_ptr<const std::vector<float>> data; //!< packed vertex data. Copies of the mesh, such as the instances of a Prefab, share it.
 
 	operator const std::shared_ptr<GraphicsEngine::Shape> &() const { return mesh; }
 
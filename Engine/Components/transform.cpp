@@ -1,25 +1,108 @@
 #include "transform.h"
+#include "glm/ext/matrix_transform.hpp"
 
 namespace Saga {
 
-Transform::Transform() { 
-	transform = std::make_shared<GraphicsEngine::ModelTransform>(); 
+Transform* Transform::setPos(glm::vec3 pos) {
+	this->pos = pos;
+	dirty = true;
+	return this;
 }
 
-glm::vec3 Transform::getPos() const {
-	return transform->getPos();
+Transform* Transform::translate(glm::vec3 delta) {
+	pos += delta;
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::setScale(glm::vec3 scale) {
+	scaleFactor = scale;
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::setScale(float scale) {
+	scaleFactor = glm::vec3(scale);
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::scale(glm::vec3 scale) {
+	scaleFactor *= scale;
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::scale(float scale) {
+	scaleFactor *= scale;
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::setRotation(float angle, glm::vec3 axis) {
+	rotation = glm::rotate(glm::mat4(1), angle, axis);
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::setRotation(glm::mat4 rotation) {
+	this->rotation = rotation;
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::rotate(float angle, glm::vec3 axis) {
+	rotation = glm::rotate(rotation, angle, axis);
+	dirty = true;
+	return this;
+}
+
+Transform* Transform::rotate(glm::mat4 rotation) {
+	this->rotation = rotation * this->rotation;
+	dirty = true;
+	return this;
 }
 
 glm::vec3 Transform::getUp() const {
-	glm::mat4 matrix = transform->getRotation();
 	// should be in column 1 (0-indexed)
-	return glm::vec3(matrix[1][0], matrix[1][1], matrix[1][2]);
+	return glm::vec3(rotation[1][0], rotation[1][1], rotation[1][2]);
 }
 
 glm::vec3 Transform::getForward() const {
-	glm::mat4 matrix = transform->getRotation();
 	// should be in column 2 (0-indexed)
-	return glm::vec3(matrix[2][0], matrix[2][1], matrix[2][2]);
+	return glm::vec3(rotation[2][0], rotation[2][1], rotation[2][2]);
+}
+
+Transform* Transform::setFromMatrix(const glm::mat4& matrix) {
+	pos = glm::vec3(matrix[3]);
+	rotation = glm::mat4(1);
+	for (int column = 0; column < 3; column++) {
+		scaleFactor[column] = glm::length(glm::vec3(matrix[column]));
+		if (scaleFactor[column] != 0) rotation[column] = glm::vec4(glm::vec3(matrix[column]) / scaleFactor[column], 0);
+	}
+	dirty = true;
+	return this;
+}
+
+const glm::mat4& Transform::getModelMatrix() {
+	if (dirty && !hasParent) updateModelMatrix();
+	return modelMatrix;
+}
+
+void Transform::updateModelMatrix(const Transform* parent) {
+	// translate * rotation * scale, without the full matrix products:
+	// scaling multiplies the rotation's columns, and translating adds the position weighted by each column's w.
+	glm::vec4 translation = glm::vec4(pos, 0);
+	for (int column = 0; column < 4; column++) {
+		glm::vec4 scaled = column < 3 ? rotation[column] * scaleFactor[column] : rotation[column];
+		modelMatrix[column] = scaled + translation * scaled.w;
+	}
+	if (parent) {
+		modelMatrix = parent->modelMatrix * modelMatrix;
+		parentVersion = parent->version;
+	}
+	version++;
+	dirty = false;
 }
 
-} // namespace Saga
\ No newline at end of file
+} // namespace Saga
@@ -1,29 +1,130 @@
 #pragma once
 
-#include "Graphics/modeltransform.h"
-#include <memory>
+#include "glm/glm.hpp"
+#include <cstdint>
 
 namespace Saga {
 /**
- * @brief A wrapper around a shared pointer to a ModelTransform.
+ * @brief The position, rotation and scale of an entity.
  * This tells object where to position themselves in a 3D scene.
+ *
+ * The model matrix is cached inside the transform, and only rebuilt after the transform changes.
+ * Changed transforms are rebuilt in bulk by the transformSystem before drawing, so that the shadow pass,
+ * the main pass, and physics all read the same cached matrix.
+ *
+ * A transform attached to another entity through Saga::Hierarchy is relative to that entity's transform.
+ * Its model matrix is then the world matrix: the parent's model matrix times its own. 
+ * Only the transformSystem rebuilds those, as building them needs the parent.
  * @ingroup component
  */
 struct Transform {
-	std::shared_ptr<GraphicsEngine::ModelTransform> transform;
+	/**
+	 * @brief Construct a new Transform object at the origin, with no rotation and a scale of 1.
+	 */
+	Transform() = default;
+
+	/**
+	 * @brief Set the position of the transform.
+	 *
+	 * @param pos
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setPos(glm::vec3 pos);
+
+	/**
+	 * @brief Move the transform.
+	 *
+	 * @param delta added to the position.
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* translate(glm::vec3 delta);
+
+	/**
+	 * @return glm::vec3 the position of the transform, relative to its parent if it has one.
+	 */
+	glm::vec3 getPos() const { return pos; }
+
+	/**
+	 * @return glm::vec3 the position of the transform in the world. For a transform with a parent, 
+	 * this is as of the last time its model matrix was built.
+	 */
+	glm::vec3 getWorldPos() const { return hasParent ? glm::vec3(modelMatrix[3]) : pos; }
+
+	/**
+	 * @brief Set the scale of the transform along each axis.
+	 *
+	 * @param scale
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setScale(glm::vec3 scale);
+
+	/**
+	 * @brief Set the scale of the transform along every axis.
+	 *
+	 * @param scale
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setScale(float scale);
 
-	operator const std::shared_ptr<GraphicsEngine::ModelTransform> &() const { return transform; }
+	/**
+	 * @brief Multiply the scale of the transform along each axis.
+	 *
+	 * @param scale
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* scale(glm::vec3 scale);
 
 	/**
-	 * @brief Construct a new Transform object.
-	 * @note this requests the graphics engine for a model transform.
+	 * @brief Multiply the scale of the transform along every axis.
+	 *
+	 * @param scale
+	 * @return Transform* this, so that calls can be chained.
 	 */
-	Transform();
+	Transform* scale(float scale);
 
 	/**
-	 * @return glm::vec3 the position of the transform.
+	 * @return glm::vec3 the scale of the transform.
 	 */
-	glm::vec3 getPos() const;
+	glm::vec3 getScale() const { return scaleFactor; }
+
+	/**
+	 * @brief Set the rotation of the transform to a rotation around an axis.
+	 *
+	 * @param angle in radians.
+	 * @param axis
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setRotation(float angle, glm::vec3 axis);
+
+	/**
+	 * @brief Set the rotation of the transform.
+	 *
+	 * @param rotation a rotation matrix.
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setRotation(glm::mat4 rotation);
+
+	/**
+	 * @brief Rotate the transform around an axis, in its local space.
+	 *
+	 * @param angle in radians.
+	 * @param axis
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* rotate(float angle, glm::vec3 axis);
+
+	/**
+	 * @brief Apply a rotation on top of the current one.
+	 *
+	 * @param rotation a rotation matrix.
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* rotate(glm::mat4 rotation);
+
+	/**
+	 * @return glm::mat4 the rotation of the transform.
+	 */
+	const glm::mat4& getRotation() const { return rotation; }
 
 	/**
 	 * @return glm::vec3 the up vector of the transform.
@@ -34,5 +135,64 @@ struct Transform {
 	 * @return glm::vec3 the forward vector of the transform.
 	 */
 	glm::vec3 getForward() const;
+
+	/**
+	 * @brief Set the position, rotation and scale of the transform from a matrix built out of them.
+	 *
+	 * @param matrix translation * rotation * scale, where the scale is positive.
+	 * @return Transform* this, so that calls can be chained.
+	 */
+	Transform* setFromMatrix(const glm::mat4& matrix);
+
+	/**
+	 * @brief Get the model matrix of the transform, which is translation * rotation * scale, times the parent's model matrix if it has one.
+	 * If the transform changed since the matrix was last built and has no parent, it is rebuilt first.
+	 *
+	 * @return const glm::mat4& the cached model matrix.
+	 */
+	const glm::mat4& getModelMatrix();
+
+	/**
+	 * @return true if the transform changed since its model matrix was last built.
+	 * @return false otherwise.
+	 */
+	bool isDirty() const { return dirty; }
+
+	/**
+	 * @brief Rebuild the cached model matrix, and clear the dirty flag.
+	 *
+	 * @param parent the transform of the parent, whose model matrix must be up to date. Null for transforms without a parent.
+	 */
+	void updateModelMatrix(const Transform* parent = nullptr);
+
+	/**
+	 * @param parent the transform of the parent.
+	 * @return true if the model matrix is out of date, either because this transform changed, or because the parent's model matrix was rebuilt since.
+	 * @return false otherwise.
+	 */
+	bool isStale(const Transform& parent) const { return dirty || parentVersion != parent.version; }
+
+	/**
+	 * @brief Mark whether this transform is relative to a parent. This is done by Saga::Hierarchy.
+	 *
+	 * @param attached
+	 */
+	void setAttached(bool attached) { hasParent = attached; dirty = true; }
+
+	/**
+	 * @return true if this transform is relative to a parent.
+	 * @return false otherwise.
+	 */
+	bool isAttached() const { return hasParent; }
+
+private:
+	glm::vec3 pos = glm::vec3(0);
+	glm::vec3 scaleFactor = glm::vec3(1);
+	bool dirty = false; //!< whether modelMatrix is out of date.
+	bool hasParent = false; //!< whether the transform is relative to a parent.
+	std::uint32_t version = 0; //!< number of times modelMatrix was rebuilt, so children can tell when to follow.
+	std::uint32_t parentVersion = 0; //!< the parent's version when modelMatrix was last built.
+	glm::mat4 rotation = glm::mat4(1);
+	glm::mat4 modelMatrix = glm::mat4(1); //!< the cached model matrix. Only valid when the transform is not dirty.
 };
 } // namespace Saga
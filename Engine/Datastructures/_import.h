@@ -5,5 +5,6 @@
  * @defgroup datastructures
  */
 #include "typemap.h"
+#include "typeOrder.h"
 #include "evenmap.h"
 #include "Accelerant/bvh.h"
@@ -1,32 +1,57 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <typeinfo>
 #include <unordered_map>
 #include <functional>
-#include <iostream>
 #include <memory>
+#include <utility>
+#include <vector>
+#include "sparseSet.h"
 #include "../_Core/logger.h"
 
 // maps event (practically ints) to functions
 namespace Saga {
+	/**
+	 * @brief Hand out a new signature id. Used by getCallbackSignature().
+	 */
+	inline int nextCallbackSignature() {
+		static std::atomic_int lastSignature(0);
+		return lastSignature++;
+	}
+
+	/**
+	 * @brief Get an id for a list of argument types. Callbacks are checked against it, instead of relying on RTTI.
+	 * 
+	 * @tparam DataType the types of data a callback accepts.
+	 * @return int the same value for the same list of types.
+	 */
+	template <typename ...DataType>
+	int getCallbackSignature() {
+		static int signature = nextCallbackSignature();
+		return signature;
+	}
+
 	/**
 	 * @brief Generic callback used for events.
 	 */
 	class ICallback {
 		public:
+			ICallback(int signature) : signature(signature) {}
 			virtual ~ICallback() = default;
+
+			const int signature; //!< the getCallbackSignature() of the types the callback accepts.
 	};
 
 	/**
-	 * @brief A wrapper around a shared_ptr to a function.
+	 * @brief A wrapper around a function.
 	 * 
 	 * @tparam DataType the types of data the function accepts.
 	 */
 	template <typename ...DataType>
 	class Callback : public ICallback {
     public:
-		Callback(std::shared_ptr<std::function<void(DataType...)>> func) : func(func) {}
+		Callback(std::function<void(DataType...)> func) : ICallback(getCallbackSignature<DataType...>()), func(std::move(func)) {}
 
 		/**
 		 * @brief Call the function this stores.
@@ -36,37 +61,151 @@ namespace Saga {
         void evoke(DataType... args) { 
             if (!func) {
                 SERROR("trying to evoke a null pointer");
-            } else (*func)(args...); 
+            } else func(args...); 
         }
 
+		/**
+		 * @brief Downcast a generic callback, checking that it accepts these types.
+		 * 
+		 * @param callback 
+		 * @return Callback* the callback, or nullptr if it accepts different types.
+		 */
+		static Callback* cast(ICallback* callback) {
+			if (!callback || callback->signature != getCallbackSignature<DataType...>()) return nullptr;
+			return static_cast<Callback*>(callback);
+		}
+
 	private:
-		std::shared_ptr<std::function<void(DataType...)>> func;
+		std::function<void(DataType...)> func;
 	};
 
 	/**
 	 * @brief A mapping between events (which are ints under the hood) and callbacks.
+	 * Each event has a channel, which holds all listeners of the event in a contiguous list. The types a channel accepts are fixed
+	 * by its first listener, so invoking an event is a single lookup followed by a linear walk through its listeners, with no casts per listener.
      * @ingroup datastructures
 	 */
 	class EventMap {
 	public: 
 		enum Id: uint64_t {};
-	private:
-		using Map = std::unordered_map<int, std::unordered_map<Id, std::shared_ptr<ICallback>>>;
-	public:
-		typedef typename Map::iterator iterator;
-		typedef typename Map::const_iterator const_iterator;
-		typedef typename Map::value_type value_type;
 
-		const_iterator begin() const { return map.begin(); }
-		const_iterator end() const { return map.end(); }
-		iterator begin() { return map.begin(); }
-		iterator end() { return map.end(); }
+		/**
+		 * @brief Generic list of listeners, all accepting the same types.
+		 */
+		class IChannel {
+		public:
+			IChannel(int signature) : signature(signature) {}
+			virtual ~IChannel() = default;
+
+			/**
+			 * @brief Remove a listener by its id.
+			 * 
+			 * @param id 
+			 * @return true if the channel had that listener.
+			 * @return false otherwise.
+			 */
+			virtual bool removeListener(Id id) = 0;
 
-		template <typename Event>
-		iterator find(Event event) { return map.find((int) event); }
+			const int signature; //!< the getCallbackSignature() of the types the listeners accept.
+		};
 
-		template <typename Event>
-		const_iterator find(Event event) const { return map.find((int) event); }
+		/**
+		 * @brief A list of listeners accepting the same types, in the order they were added.
+		 * 
+		 * @tparam DataType the types of data the listeners accept.
+		 */
+		template <typename ...DataType>
+		class Channel : public IChannel {
+		public:
+			Channel() : IChannel(getCallbackSignature<DataType...>()) {}
+
+			/**
+			 * @brief Add a listener. If the channel is being invoked, the listener is only added once that finishes.
+			 * 
+			 * @param id 
+			 * @param listener 
+			 */
+			void addListener(Id id, std::function<void(DataType...)> listener) {
+				if (invoking) {
+					pendingAdds.emplace_back(id, std::move(listener));
+					return;
+				}
+				ids.push_back(id);
+				listeners.push_back(std::move(listener));
+			}
+
+			virtual bool removeListener(Id id) override {
+				auto it = std::find(ids.begin(), ids.end(), id);
+				if (invoking) {
+					// the listener may be the one running right now, so it stays in place until the invocation finishes
+					if (it == ids.end()) return false;
+					pendingRemoves.push_back(id);
+					return true;
+				}
+				if (it == ids.end()) return false;
+				listeners.erase(listeners.begin() + (it - ids.begin()));
+				ids.erase(it);
+				return true;
+			}
+
+			/**
+			 * @brief Call every listener, in the order they were added. 
+			 * Listeners added or removed by a listener take effect once the outermost invocation finishes.
+			 * 
+			 * @param args 
+			 */
+			void invoke(DataType... args) {
+				invoking++;
+				for (std::size_t i = 0; i < listeners.size(); i++)
+					listeners[i](args...);
+				if (--invoking) return;
+
+				for (Id id : pendingRemoves) removeListener(id);
+				pendingRemoves.clear();
+				for (auto& [id, listener] : pendingAdds) addListener(id, std::move(listener));
+				pendingAdds.clear();
+			}
+
+			/**
+			 * @brief Downcast a generic channel, checking that it accepts these types.
+			 * 
+			 * @param channel 
+			 * @return Channel* the channel, or nullptr if it accepts different types.
+			 */
+			static Channel* cast(IChannel* channel) {
+				if (!channel || channel->signature != getCallbackSignature<DataType...>()) return nullptr;
+				return static_cast<Channel*>(channel);
+			}
+
+		private:
+			std::vector<Id> ids; //!< id of each listener.
+			std::vector<std::function<void(DataType...)>> listeners;
+
+			int invoking = 0; //!< depth of nested invocations of this channel.
+			std::vector<std::pair<Id, std::function<void(DataType...)>>> pendingAdds; //!< listeners added while invoking.
+			std::vector<Id> pendingRemoves; //!< listeners removed while invoking.
+		};
+
+		/**
+		 * @brief Add a listener to a channel, creating the channel if needed.
+		 * 
+		 * @tparam DataType the type of data the listener accepts.
+		 * @param channel 
+		 * @param listener 
+		 * @return Id the id of the listener, or 0 if the channel already accepts different types.
+		 */
+		template <typename ...DataType>
+		static Id addToChannel(std::unique_ptr<IChannel>& channel, std::function<void(DataType...)> listener) {
+			if (!channel) channel = std::make_unique<Channel<DataType...>>();
+			Channel<DataType...>* typed = Channel<DataType...>::cast(channel.get());
+			if (!typed) {
+				SERROR("Trying to add a listener to an event whose listeners accept different types.");
+				return Id(0);
+			}
+			const Id id = Id(++id_value());
+			typed->addListener(id, std::move(listener));
+			return id;
+		}
 
 		/**
 		 * @brief Add a listener to a specific event
@@ -78,11 +217,8 @@ namespace Saga {
 		 * @return Id the id of the listener. This can be use to remove the listener later.
 		 */
 		template <typename Event, typename ...DataType>
-		Id addListener(Event event, std::shared_ptr<std::function<void(DataType...)>> callbackFunc) {
-			const Id id = Id(++id_value());
-
-			map[(int) event][id] = std::make_shared<Callback<DataType...>>(callbackFunc);
-			return id;
+		Id addListener(Event event, std::function<void(DataType...)> callbackFunc) {
+			return addToChannel(map[(int) event], std::move(callbackFunc));
 		}
 
 		/**
@@ -94,9 +230,9 @@ namespace Saga {
 		 */
 		template <typename Event>
 		void removeListener(Event event, Id id) {
-			if (map.count((int) event)) {
-				int removeCnt = map[(int) event].erase(id);
-				if (!removeCnt) SWARN("Trying to remove listener %d from event %d, but the event does not have this listener.", id, event);
+			auto it = map.find((int) event);
+			if (it != map.end()) {
+				if (!it->second->removeListener(id)) SWARN("Trying to remove listener %d from event %d, but the event does not have this listener.", id, event);
 			} else 
 				SWARN("Trying to remove a listener from event %d, but the event does not exist.", event);
 		}
@@ -111,11 +247,14 @@ namespace Saga {
 		 */
 		template <typename Event, typename ...DataType>
 		void invoke(Event event, DataType... args) {
-            if (map.count((int) event))
-                for (auto& [key, callback] : map[(int) event]) {
-                    auto ptr = std::dynamic_pointer_cast<Callback<DataType...>>(callback);
-                    ptr->evoke(args...);
-                }
+			auto it = map.find((int) event);
+			if (it == map.end()) return;
+			Channel<DataType...>* channel = Channel<DataType...>::cast(it->second.get());
+			if (!channel) {
+				SERROR("Invoking event %d with types its listeners do not accept.", event);
+				return;
+			}
+			channel->invoke(args...);
 		}
 
         /**
@@ -130,11 +269,91 @@ namespace Saga {
         }
 
 	private:
-		Map map;
+		std::unordered_map<int, std::unique_ptr<IChannel>> map; //!< channel of each event.
 		static auto id_value()
-			-> uint64_t & {
-			static uint64_t the_id;
+			-> std::atomic<uint64_t> & {
+			static std::atomic<uint64_t> the_id(0);
 			return the_id;
 		}
 	};
+
+	/**
+	 * @brief A mapping between entities and callbacks, for a single event. 
+	 * Entities are looked up through a SparseSet, so delivering to an entity is an array access rather than a hash lookup.
+     * @ingroup datastructures
+	 */
+	class EntityEventMap {
+	public:
+		/**
+		 * @brief Add a listener for an entity.
+		 * 
+		 * @tparam DataType the type of data the listener accepts.
+		 * @param entity 
+		 * @param listener 
+		 * @return EventMap::Id the id of the listener. This can be used to remove the listener later.
+		 */
+		template <typename ...DataType>
+		EventMap::Id addListener(Entity entity, std::function<void(DataType...)> listener) {
+			std::uint32_t index = entities.find(entity);
+			if (index == SparseSet::NULL_INDEX) {
+				index = entities.insert(entity);
+				channels.emplace_back();
+			}
+			return EventMap::addToChannel(channels[index], std::move(listener));
+		}
+
+		/**
+		 * @brief Remove a listener of an entity, by its id.
+		 * 
+		 * @param entity 
+		 * @param id 
+		 */
+		void removeListener(Entity entity, EventMap::Id id) {
+			std::uint32_t index = entities.find(entity);
+			if (index == SparseSet::NULL_INDEX || !channels[index]->removeListener(id))
+				SWARN("Trying to remove listener %d from entity %d, but the entity does not have this listener.", id, entity);
+		}
+
+		/**
+		 * @brief Call all listeners of an entity.
+		 * 
+		 * @tparam DataType 
+		 * @param entity 
+		 * @param args the parameters used in calling the listeners.
+		 */
+		template <typename ...DataType>
+		void invoke(Entity entity, DataType... args) {
+			std::uint32_t index = entities.find(entity);
+			if (index == SparseSet::NULL_INDEX) return;
+			EventMap::Channel<DataType...>* channel = EventMap::Channel<DataType...>::cast(channels[index].get());
+			if (!channel) {
+				SERROR("Delivering an event to entity %d with types its listeners do not accept.", entity);
+				return;
+			}
+			channel->invoke(args...);
+		}
+
+		/**
+		 * @brief Remove all listeners of an entity.
+		 * 
+		 * @param entity 
+		 */
+		void removeEntity(Entity entity) {
+			if (!entities.contains(entity)) return;
+			// the set moves its last entity into the hole, so we do the same with the channels
+			std::uint32_t index = entities.remove(entity);
+			channels[index] = std::move(channels.back());
+			channels.pop_back();
+		}
+
+		/**
+		 * @return true if no entity has listeners for this event.
+		 * @return false otherwise.
+		 */
+		bool empty() const { return entities.size() == 0; }
+
+	private:
+		SparseSet entities; //!< entities with listeners.
+		std::vector<std::unique_ptr<EventMap::IChannel>> channels; //!< channels[i] holds the listeners of entities.at(i).
+	};
 }
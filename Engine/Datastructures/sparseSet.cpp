@@ -0,0 +1,38 @@
+#include "sparseSet.h"
+#include <algorithm>
+#include <utility>
+
+namespace Saga {
+    std::uint32_t SparseSet::insert(Entity entity) {
+        std::uint32_t index = dense.size();
+        assure(entity) = index;
+        dense.push_back(entity);
+        return index;
+    }
+
+    std::uint32_t SparseSet::remove(Entity entity) {
+        std::uint32_t index = find(entity);
+        std::uint32_t last = dense.size() - 1;
+        if (index != last) swap(index, last);
+        assure(entity) = NULL_INDEX;
+        dense.pop_back();
+        return index;
+    }
+
+    void SparseSet::swap(std::uint32_t indexA, std::uint32_t indexB) {
+        std::swap(dense[indexA], dense[indexB]);
+        assure(dense[indexA]) = indexA;
+        assure(dense[indexB]) = indexB;
+    }
+
+    std::uint32_t& SparseSet::assure(Entity entity) {
+        std::uint32_t id = getEntityIndex(entity);
+        std::uint32_t page = id / PAGE_SIZE;
+        if (page >= sparse.size()) sparse.resize(page + 1);
+        if (!sparse[page]) {
+            sparse[page] = std::make_unique<std::uint32_t[]>(PAGE_SIZE);
+            std::fill_n(sparse[page].get(), PAGE_SIZE, NULL_INDEX);
+        }
+        return sparse[page][id % PAGE_SIZE];
+    }
+}
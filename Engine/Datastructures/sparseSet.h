@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Engine/Entity/entity.h"
+
+namespace Saga {
+    /**
+     * @brief A set of entities packed into the index range [0, size()).
+     * Each entity is looked up through a paged sparse array indexed by its slot index,
+     * so finding, inserting, and removing an entity are all O(1) array accesses with no hashing.
+     * Since the dense array stores the full Entity, handles from an older generation of the same slot are not found.
+     * Pages of the sparse array are only allocated when an entity in their range is inserted.
+     *
+     * @ingroup datastructures
+     */
+    class SparseSet {
+    public:
+        static constexpr std::uint32_t PAGE_SIZE = 4096; //!< number of entity indices covered by a single page of the sparse array.
+        static constexpr std::uint32_t NULL_INDEX = UINT32_MAX; //!< returned by find() when the entity is not in the set.
+
+        /**
+         * @brief Find where an entity lives in the dense array.
+         *
+         * @param entity
+         * @return std::uint32_t the index of the entity in the dense array, or NULL_INDEX if the set does not contain it.
+         */
+        inline std::uint32_t find(Entity entity) const {
+            std::uint32_t id = getEntityIndex(entity);
+            std::uint32_t page = id / PAGE_SIZE;
+            if (page >= sparse.size() || !sparse[page]) return NULL_INDEX;
+            std::uint32_t index = sparse[page][id % PAGE_SIZE];
+            // the dense check guards against stale entries in the sparse array
+            if (index >= dense.size() || dense[index] != entity) return NULL_INDEX;
+            return index;
+        }
+
+        /**
+         * @brief Determine if the set contains an entity.
+         *
+         * @param entity
+         * @return true if it does.
+         * @return false otherwise.
+         */
+        inline bool contains(Entity entity) const { return find(entity) != NULL_INDEX; }
+
+        /**
+         * @brief Append an entity to the end of the dense array. The entity must not already be in the set.
+         *
+         * @param entity
+         * @return std::uint32_t the index of the entity in the dense array, which is always size()-1 after insertion.
+         */
+        std::uint32_t insert(Entity entity);
+
+        /**
+         * @brief Remove an entity from the set, by swapping it with the last entity in the dense array and then popping the back.
+         * The entity must be in the set.
+         *
+         * @param entity
+         * @return std::uint32_t the index the entity used to occupy, which now holds what used to be the last entity.
+         */
+        std::uint32_t remove(Entity entity);
+
+        /**
+         * @brief Swap the position of two entries in the dense array.
+         *
+         * @param indexA
+         * @param indexB
+         */
+        void swap(std::uint32_t indexA, std::uint32_t indexB);
+
+        /**
+         * @brief Reserve space for a number of entities in the dense array.
+         *
+         * @param capacity
+         */
+        void reserve(std::size_t capacity) { dense.reserve(capacity); }
+
+        /**
+         * @brief Remove every entity from the set. Pages of the sparse array are kept around for reuse.
+         */
+        void clear() { dense.clear(); }
+
+        /**
+         * @param index an index in the range [0, size()).
+         * @return Entity the entity at that index of the dense array.
+         */
+        inline Entity at(std::uint32_t index) const { return dense[index]; }
+
+        /**
+         * @return std::size_t the number of entities in the set.
+         */
+        inline std::size_t size() const { return dense.size(); }
+
+        /**
+         * @return const std::vector<Entity>& all entities in the set, in dense order.
+         */
+        inline const std::vector<Entity>& entities() const { return dense; }
+
+    private:
+        std::vector<std::unique_ptr<std::uint32_t[]>> sparse; //!< pages mapping entity index to index in the dense array.
+        std::vector<Entity> dense; //!< all entities in the set, packed.
+
+        /**
+         * @brief Get the sparse array entry for an entity, allocating the page it lives on if needed.
+         *
+         * @param entity
+         * @return std::uint32_t& the entry, which can be assigned to.
+         */
+        std::uint32_t& assure(Entity entity);
+    };
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+// orders types at compile time
+namespace Saga {
+	/**
+	 * @brief Get a string that identifies a type at compile time. This is the signature of this function as the compiler
+	 * spells it, so it contains the type's fully qualified name, and is the same in every translation unit.
+	 *
+	 * @tparam Type the type.
+	 * @return std::string_view a key to order types with.
+     * @ingroup datastructures
+	 */
+	template <class Type>
+	constexpr std::string_view typeKey() {
+#if defined(_MSC_VER)
+		return __FUNCSIG__;
+#else
+		return __PRETTY_FUNCTION__;
+#endif
+	}
+
+	/**
+	 * @brief Sorts a list of types by their typeKey(), so that any permutation of the same types produces the same list.
+	 *
+	 * @tparam Type the types to sort. These must all be different.
+     * @ingroup datastructures
+	 */
+	template <class... Type>
+	class SortedTypes {
+		/**
+		 * @tparam Current one of the types.
+		 * @return std::size_t the position of Current once the list is sorted.
+		 */
+		template <class Current>
+		static constexpr std::size_t rankOf() { return ((typeKey<Type>() < typeKey<Current>()) + ... + 0); }
+
+		static constexpr std::array<std::size_t, sizeof...(Type)> ranks = { rankOf<Type>()... }; //!< sorted position of each type, in the original order.
+
+		/**
+		 * @param rank a position in the sorted list.
+		 * @return std::size_t the position in the original list of the type that ends up there.
+		 */
+		static constexpr std::size_t positionOf(std::size_t rank) {
+			for (std::size_t i = 0; i < ranks.size(); i++)
+				if (ranks[i] == rank) return i;
+			return ranks.size();
+		}
+
+		template <template <class...> class Target, std::size_t... rank>
+		static auto apply(std::index_sequence<rank...>) -> Target<std::tuple_element_t<positionOf(rank), std::tuple<Type...>>...>;
+
+	public:
+		/**
+		 * @brief The sorted types, as the arguments of a template.
+		 *
+		 * @tparam Target the template to instantiate.
+		 */
+		template <template <class...> class Target>
+		using As = decltype(apply<Target>(std::index_sequence_for<Type...>{}));
+	};
+}
@@ -71,6 +71,15 @@ namespace Saga {
 		template <class KeyType>
 		const_iterator find() const { return map.find(getTypeId<KeyType>()); }
 
+        /**
+         * @brief Find a type inside this map by its id.
+         *
+         * @param typeId the id of the type, from getTypeId().
+         * @return an iterator pointing to the key-value pair in the map with that id, or 
+         * the end iterator otherwise.
+         */
+		iterator find(int typeId) { return map.find(typeId); }
+
         /**
          * @brief Determine if the map already maps a type to some value.
          *
@@ -102,7 +111,7 @@ namespace Saga {
          * @tparam KeyType the type.
          */
 		template <class KeyType>
-		inline int getTypeId() {
+		static inline int getTypeId() {
             static int id = LastTypeId++;
 			return id;
 		}
@@ -1,4 +1,4 @@
-#pragma once 
+#pragma once
 
 #include <cstdint>
 
@@ -7,8 +7,37 @@ namespace Saga {
 using entity_type = std::uint32_t;
 
 /**
- * @brief Literally an int.
+ * @brief Literally an int. The low ENTITY_INDEX_BITS bits are the index of the slot the entity occupies in its world,
+ * and the remaining bits are the generation of that slot. Slots are recycled when entities are destroyed,
+ * and their generation is bumped so that handles to the destroyed entity can be told apart from the new one.
  */
 enum class Entity: entity_type;
 
+const entity_type ENTITY_INDEX_BITS = 20; //!< number of bits of an Entity used for its index. This bounds the number of live entities in a world.
+const entity_type ENTITY_INDEX_MASK = (entity_type(1) << ENTITY_INDEX_BITS) - 1; //!< mask to extract the index of an Entity.
+const entity_type ENTITY_GENERATION_MASK = ~entity_type(0) >> ENTITY_INDEX_BITS; //!< mask to extract the generation of an Entity, after shifting.
+
+/**
+ * @param entity
+ * @return entity_type the index of the slot the entity occupies.
+ */
+inline constexpr entity_type getEntityIndex(Entity entity) { return (entity_type) entity & ENTITY_INDEX_MASK; }
+
+/**
+ * @param entity
+ * @return entity_type the generation of the entity. Increments every time the slot is recycled.
+ */
+inline constexpr entity_type getEntityGeneration(Entity entity) { return (entity_type) entity >> ENTITY_INDEX_BITS; }
+
+/**
+ * @brief Assemble an Entity from its index and generation.
+ *
+ * @param index the slot index. Must fit in ENTITY_INDEX_BITS bits.
+ * @param generation the generation. Wraps around if it does not fit.
+ * @return Entity
+ */
+inline constexpr Entity makeEntity(entity_type index, entity_type generation) {
+	return (Entity) ((index & ENTITY_INDEX_MASK) | ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS));
+}
+
 } // namespace Saga
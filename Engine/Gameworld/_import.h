@@ -1,4 +1,5 @@
 #pragma once
 
 #include "gameworld.h"
-#include "componentReference.h"
\ No newline at end of file
+#include "componentReference.h"
+#include "prefab.h"
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "commandBuffer.h"
+#include <algorithm>
+#include "gameworld.h"
+#include "../_Core/asserts.h"
+
+namespace Saga {
+
+Entity CommandBuffer::createEntity() {
+	// the world's slots and free slots only change right after a commit, which never overlaps with recording, so they are stable here
+	entity_type reserved = reservedCnt.fetch_add(1, std::memory_order_relaxed);
+	std::size_t freeCnt = world.freeSlots.size();
+	// free slots are taken from the back, like GameWorld::createEntity(). Their handle already carries the next generation
+	if (reserved < freeCnt) return world.entitySlots[world.freeSlots[freeCnt - 1 - reserved]];
+
+	entity_type index = world.entitySlots.size() + (reserved - freeCnt);
+	SASSERT_MESSAGE(index < ENTITY_INDEX_MASK, "Too many live entities in the world. Consider increasing ENTITY_INDEX_BITS in entity.h.");
+	return makeEntity(index, 0);
+}
+
+void CommandBuffer::destroyEntity(Entity entity) {
+	std::lock_guard<std::mutex> lock(mutex);
+	destroyed.push_back(entity);
+}
+
+void CommandBuffer::commitEntities() {
+	entity_type cnt = reservedCnt.exchange(0, std::memory_order_relaxed);
+	if (!cnt) return;
+
+	// the free slots handed out were the last ones, so they are popped all at once
+	entity_type recycled = std::min<std::size_t>(cnt, world.freeSlots.size());
+	world.freeSlots.resize(world.freeSlots.size() - recycled);
+	cnt -= recycled;
+
+	entity_type first = world.entitySlots.size();
+	world.entitySlots.reserve(first + cnt);
+	world.entitySignatures.resize(first + cnt);
+	for (entity_type index = first; index < first + cnt; index++)
+		world.entitySlots.push_back(makeEntity(index, 0));
+}
+
+void CommandBuffer::playback() {
+	// entities created through the buffer have to be alive before changes to them are applied
+	commitEntities();
+
+	// anything recorded while playing back is left for the next playback
+	std::vector<int> ids;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		ids.swap(pending);
+	}
+	for (int id : ids)
+		queues[id]->playback(world);
+
+	// destruction is deferred further, to the rest of entityCleanup
+	std::vector<Entity> entities;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		entities.swap(destroyed);
+	}
+	world.destroyEntities(entities);
+}
+
+} // namespace Saga
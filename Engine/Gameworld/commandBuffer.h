@@ -0,0 +1,167 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../Entity/entity.h"
+
+namespace Saga {
+
+class GameWorld;
+
+/**
+ * @brief Generic queue of structural changes for a single component type.
+ */
+class ICommandQueue {
+public:
+	/**
+	 * @brief Destroy the ICommandQueue object.
+	 */
+	virtual ~ICommandQueue() = default;
+
+	/**
+	 * @brief Apply every recorded change to the world, then empty the queue.
+	 * 
+	 * @param world 
+	 */
+	virtual void playback(GameWorld& world) = 0;
+};
+
+/**
+ * @brief Queue of emplaces and removals of a single component type, in the order they were recorded.
+ * 
+ * @tparam Component the type of the component.
+ */
+template <typename Component>
+class CommandQueue : public ICommandQueue {
+public:
+	/**
+	 * @brief Record the emplacement of a component.
+	 * 
+	 * @param entity 
+	 * @param component the component, already constructed.
+	 */
+	void emplace(Entity entity, Component&& component);
+
+	/**
+	 * @brief Record the removal of a component.
+	 * 
+	 * @param entity 
+	 */
+	void remove(Entity entity);
+
+	/**
+	 * @brief Apply every recorded change to the world, sorted by entity, then empty the queue. 
+	 * The component container is batched, so it is resized at most once on the way up and once on the way down.
+	 * 
+	 * @param world 
+	 */
+	virtual void playback(GameWorld& world) override;
+private:
+	/**
+	 * @brief A single recorded change. 
+	 */
+	struct Command {
+		Entity entity;
+		bool remove; //!< whether this removes the component, rather than emplacing it.
+		std::uint32_t component; //!< when emplacing, the index of the component in components.
+	};
+	std::vector<Command> commands; //!< changes, in the order they were recorded.
+	std::vector<Component> components; //!< components to emplace, stored by value so that recording does not allocate once the vector has grown.
+};
+
+/**
+ * @brief Records structural changes to a GameWorld, so that they can be applied all at once when no System is iterating through the world.
+ * Emplacing or removing a component immediately can resize its container and walk through groups, 
+ * which drops pointers held by whoever is currently iterating. Recording the change here instead defers it to the next entityCleanup.
+ * 
+ * Creating an entity hands out its handle immediately, so that it can be used to record more changes, 
+ * but the entity only becomes alive once the buffer is played back.
+ * Changes are played back one component type at a time, in the order each type was first recorded. 
+ * Changes to the same component of the same entity are applied in the order they were recorded, but changes to different component types are not ordered 
+ * relative to each other: removing a Transform and then emplacing a Collider may be applied the other way around. Destroying an entity is always applied last.
+ * Recording is thread safe, and never touches the world itself, so Systems running in parallel can share the buffer.
+ */
+class CommandBuffer {
+public:
+	/**
+	 * @brief Construct a new Command Buffer for a world.
+	 * 
+	 * @param world the world this buffer records changes for.
+	 */
+	CommandBuffer(GameWorld& world) : world(world) {}
+
+	/**
+	 * @brief Create an Entity. The handle can be recorded against immediately, and the entity is alive from the next playback on.
+	 * Slots freed by destroyed entities are reserved first, through an atomic cursor over the world's free slots, so spawning and destroying through 
+	 * the buffer keeps the world's size bounded. Only once those run out are fresh slots reserved past the end of the world's slots.
+	 * Either way the world itself is left untouched until commitEntities(), so other Systems can keep reading it.
+	 * 
+	 * @return Entity 
+	 */
+	Entity createEntity();
+
+	/**
+	 * @brief Record the emplacement of a component. The component is constructed now, and moved into the world on playback.
+	 * 
+	 * @tparam Component the type of the component.
+	 * @tparam Args the type of the parameters used to construct the Component.
+	 * @param entity 
+	 * @param args the arguments used to construct the Component.
+	 */
+	template <typename Component, typename... Args>
+	void emplace(Entity entity, Args &&...args);
+
+	/**
+	 * @brief Record the removal of a component.
+	 * 
+	 * @tparam Component the type of the component.
+	 * @param entity 
+	 */
+	template <typename Component>
+	void removeComponent(Entity entity);
+
+	/**
+	 * @brief Destroy an Entity once the buffer has been played back.
+	 * 
+	 * @param entity 
+	 */
+	void destroyEntity(Entity entity);
+
+	/**
+	 * @brief Apply all recorded changes, one component type at a time, then empty the buffer.
+	 */
+	void playback();
+
+	/**
+	 * @return true if no changes have been recorded since the last playback.
+	 * @return false otherwise.
+	 */
+	bool empty() const { return pending.empty() && destroyed.empty() && !reservedCnt; }
+
+	/**
+	 * @brief Hand the slots reserved by createEntity() over to the world, which makes those entities alive. 
+	 * The world's free slots must not change between reserving and committing, which is why the world commits before it creates or frees slots itself.
+	 * This grows the world, so it is only called when no System is running: at playback, and before the world creates entities itself.
+	 */
+	void commitEntities();
+private:
+	GameWorld& world;
+	std::atomic<entity_type> reservedCnt = 0; //!< number of slots reserved since the last commit: first the world's free slots from the back, then fresh ones.
+	std::vector<Entity> destroyed; //!< entities to destroy on playback.
+	std::vector<std::unique_ptr<ICommandQueue>> queues; //!< queue of each component type, indexed by component id. Can be null.
+	std::vector<int> pending; //!< ids of the component types with recorded changes, in the order they were first recorded.
+	std::mutex mutex; //!< guards recording.
+
+	/**
+	 * @brief Get the queue of a component type, creating it if needed, and mark it as pending.
+	 * 
+	 * @tparam Component 
+	 * @return CommandQueue<Component>& 
+	 */
+	template <typename Component>
+	CommandQueue<Component>& getQueue();
+};
+
+} // namespace Saga
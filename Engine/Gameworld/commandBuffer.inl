@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include "commandBuffer.h"
+#include "gameworld.h"
+#include "componentContainer.h"
+#include "../_Core/logger.h"
+
+namespace Saga {
+
+template <typename Component>
+void CommandQueue<Component>::emplace(Entity entity, Component&& component) {
+	commands.push_back({entity, false, std::uint32_t(components.size())});
+	components.push_back(std::move(component));
+}
+
+template <typename Component>
+void CommandQueue<Component>::remove(Entity entity) {
+	commands.push_back({entity, true, 0});
+}
+
+template <typename Component>
+void CommandQueue<Component>::playback(GameWorld& world) {
+	// take the commands out first, so that anything recorded during playback is kept for the next one
+	std::vector<Command> batch;
+	std::vector<Component> batchComponents;
+	batch.swap(commands);
+	batchComponents.swap(components);
+
+	// sorting by entity keeps container accesses local. The sort is stable so changes to the same entity keep their order.
+	std::stable_sort(batch.begin(), batch.end(), [](const Command& a, const Command& b) {
+		return getEntityIndex(a.entity) < getEntityIndex(b.entity);
+	});
+
+	// tags are not stored, so there is nothing to reserve
+	auto container = world.viewAll<Component>();
+	if constexpr (!isTag<Component>) container->beginBatch(batchComponents.size());
+	for (Command& command : batch) {
+		// the entity might have been destroyed since the change was recorded
+		if (!world.isAlive(command.entity)) continue;
+
+		if (command.remove) {
+			world.removeComponent<Component>(command.entity);
+		} else if (world.hasComponent<Component>(command.entity)) {
+			SWARN("Trying to emplace a component onto entity %d, which already has a component of the same type. Skipped.", command.entity);
+		} else {
+			world.emplace<Component>(command.entity, std::move(batchComponents[command.component]));
+		}
+	}
+	if constexpr (!isTag<Component>) container->endBatch();
+}
+
+template <typename Component, typename... Args>
+void CommandBuffer::emplace(Entity entity, Args &&...args) {
+	Component component(std::forward<Args>(args)...);
+	std::lock_guard<std::mutex> lock(mutex);
+	getQueue<Component>().emplace(entity, std::move(component));
+}
+
+template <typename Component>
+void CommandBuffer::removeComponent(Entity entity) {
+	std::lock_guard<std::mutex> lock(mutex);
+	getQueue<Component>().remove(entity);
+}
+
+template <typename Component>
+CommandQueue<Component>& CommandBuffer::getQueue() {
+	int id = world.getTypeId<Component>();
+	if (std::size_t(id) >= queues.size()) queues.resize(id + 1);
+	if (!queues[id]) queues[id] = std::make_unique<CommandQueue<Component>>();
+	// a queue is pending as long as it has recorded something since the last playback
+	if (std::find(pending.begin(), pending.end(), id) == pending.end()) pending.push_back(id);
+	return static_cast<CommandQueue<Component>&>(*queues[id]);
+}
+
+} // namespace Saga
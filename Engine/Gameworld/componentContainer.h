@@ -1,13 +1,39 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
 #include <optional>
+#include <span>
+#include <type_traits>
 #include <vector>
-#include <unordered_map>
 #include <memory>
 #include "../Entity/entity.h"
+#include "../Datastructures/sparseSet.h"
+#include "../_Core/jobSystem.h"
+#include "eventQueue.h"
 
 namespace Saga {
 
+/**
+ * @brief Whether a component type is a tag, a type without any data such as Collider. 
+ * Tags have no storage: they only exist as bits in the Signature of entities, and their containers stay empty.
+ * 
+ * @tparam Component 
+ */
+template <typename Component>
+constexpr bool isTag = std::is_empty_v<Component>;
+
+/**
+ * @brief What pointers to a tag point to. Tags hold no data, so every entity with the tag shares this one.
+ * 
+ * @tparam Component a tag.
+ */
+template <typename Component>
+inline Component tagInstance{};
+
 /**
  * @brief Generic container of components.
  */
@@ -19,53 +45,145 @@ public:
 	virtual ~IComponentContainer() = default;
 
 	/**
-	 * @brief Handler for when an entity is deleted. This should remove the entity from the Container, as well as the associated component if it exists.
-	 * @param entity 
+	 * @brief Handler for when entities are deleted. This should remove them from the Container, as well as their associated components if they exist.
+	 * @param destroyed the entities, each listed once.
+	 */
+	virtual void onEntitiesDestroyed(std::span<const Entity> destroyed) = 0;
+
+	/**
+	 * @brief Get the last time components changed position inside the container. Useful for cacheing references from the container.
+	 * @return int time step at which components last moved.
+	 */
+	virtual int getLastReordered() = 0;
+
+	/**
+	 * @brief Set the tick that components are stamped with when they are added or changed from now on.
+	 * @param tick the world's current tick.
+	 */
+	void setTick(std::uint32_t tick) { currentTick = tick; }
+
+	/**
+	 * @brief Stamp the component at an index as changed during the current tick.
+	 * 
+	 * @param index an index in the range [0, number of components).
+	 */
+	inline void markChanged(std::uint32_t index) { changedTicks[index] = currentTick; }
+
+	/**
+	 * @param index an index in the range [0, number of components).
+	 * @return std::uint32_t the tick at which the component at that index was added.
 	 */
-	virtual void onEntityDestroyed(Entity entity) = 0;
+	inline std::uint32_t getAddedTick(std::uint32_t index) const { return addedTicks[index]; }
 
 	/**
-	 * @brief Get the last time the container was changed. Useful for cacheing references from the container
-	 * @return int time step at which the container has been changed.
+	 * @param index an index in the range [0, number of components).
+	 * @return std::uint32_t the tick at which the component at that index was last changed, or added if it has not changed since.
 	 */
-	virtual int getLastReallocated() = 0;
+	inline std::uint32_t getChangedTick(std::uint32_t index) const { return changedTicks[index]; }
+
+protected:
+	std::uint32_t currentTick = 0; //!< tick that added or changed components are stamped with.
+	std::vector<std::uint32_t> addedTicks; //!< tick at which the component at each index was added. Kept in the same order as the components.
+	std::vector<std::uint32_t> changedTicks; //!< tick at which the component at each index was last changed.
 };
 
 /**
  * @brief Container for a specific Component type.
+ * Components are stored densely next to each other, and entities are mapped to their component through a SparseSet, 
+ * so lookups are array accesses rather than hash map lookups.
+ * 
+ * Storage is split into fixed-size pages of uninitialized memory that are never reallocated, so a component keeps its address for as long as it keeps its index.
+ * Components are constructed in place when emplaced, and destroyed when removed, so they need not be default constructible. They need to be move constructible.
+ * Growing the container only adds pages. Pages left empty by removals are kept around, up to one spare page,
+ * so that a container hovering around a page boundary does not keep allocating and freeing. compact() releases every spare page.
+ * A component only moves when components are reordered: when the last component fills the hole left by a removal, or when a Packed group swaps components.
+ * 
+ * Tags, see isTag, are never stored in their container. 
+ * 
+ * Next to the components, the container keeps two ticks per component: when it was added, and when it was last changed.
+ * Emplacing stamps both. Changes are stamped by markChanged(), which mutable accesses such as ComponentReference and queries call.
  * 
  * @tparam Component the component this container manages.
  */
 template <typename Component>
 class ComponentContainer : public IComponentContainer {
+	static constexpr std::size_t PAGE_BYTES = 16384; //!< target size of a page.
 public:
+	static constexpr std::uint32_t PAGE_SIZE = std::bit_floor(std::max<std::size_t>(1, PAGE_BYTES / sizeof(Component))); //!< number of components in a page.
+
 	/**
-	 * @brief Destroy the Component Container object
+	 * @brief Iterates through the components in the order of their index.
 	 * 
+	 * @tparam Const whether the components are read only.
 	 */
-	virtual ~ComponentContainer() {}
+	template <bool Const>
+	class Iterator {
+		using Container = std::conditional_t<Const, const ComponentContainer, ComponentContainer>;
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Component;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const Component*, Component*>;
+		using reference = std::conditional_t<Const, const Component&, Component&>;
+
+		Iterator() {}
+		Iterator(Container* container, std::uint32_t index) : container(container), index(index) {}
+
+		reference operator*() const { return container->at(index); }
+		pointer operator->() const { return &container->at(index); }
+		Iterator& operator++() { index++; return *this; }
+		Iterator operator++(int) { Iterator old = *this; index++; return old; }
+		bool operator==(const Iterator& other) const { return index == other.index; }
+		bool operator!=(const Iterator& other) const { return index != other.index; }
+	private:
+		Container* container = nullptr;
+		std::uint32_t index = 0;
+	};
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	ComponentContainer() {}
+	ComponentContainer(const ComponentContainer&) = delete;
+	ComponentContainer& operator=(const ComponentContainer&) = delete;
 
 	/**
-	 * @brief Emplace a component onto an entity. This created
+	 * @brief Destroy the Component Container object, along with every component in it.
+	 * 
+	 */
+	virtual ~ComponentContainer();
+
+	/**
+	 * @brief Emplace a component onto an entity. The component is constructed directly in its slot.
 	 * 
 	 * @tparam Args the argument types that the component's constructor accepts.
 	 * @param entity the entity to add the component into.
-	 * @param args the arguments used to construct the component.
+	 * @param args the arguments used to construct the component. They are forwarded to the constructor.
 	 * @return Component* a pointer to the component.
 	 * @throw std::invalid_argument if the entity already has this component attached.
 	 */
 	template <typename... Args>
 	Component* emplace(const Entity entity, Args &&...args);
 
-	typename std::vector<Component>::iterator begin();
-	typename std::vector<Component>::iterator end();
-    typename std::vector<Component>::const_iterator begin() const;
-    typename std::vector<Component>::const_iterator end() const;
+	/**
+	 * @brief Emplace a component onto each of a list of entities. Storage is reserved once for the whole list, 
+	 * and the components are constructed one after the other at the back of the container.
+	 * 
+	 * @tparam Args the argument types that the component's constructor accepts.
+	 * @param targets the entities to add the components into. None of them may have this component already.
+	 * @param args the arguments used to construct every one of the components.
+	 */
+	template <typename... Args>
+	void emplaceBulk(std::span<const Entity> targets, const Args &...args);
+
+	iterator begin() { return iterator(this, 0); }
+	iterator end() { return iterator(this, cnt); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, cnt); }
 
     /**
      * @brief Retrieve the size of the container.
      */
-    std::size_t size() const { return std::distance(begin(), end()); }
+    std::size_t size() const { return cnt; }
 
 
 	/**
@@ -95,10 +213,10 @@ public:
 
 	/**
 	 * @brief Get an Entity with this specific component.
-	 * @warning runs in O(n).
 	 * 
 	 * @param component 
 	 * @return Entity the entity the component belongs to, or -1 if none exists.
+	 * @note this scans the pages for the one holding the pointer, so it runs in O(getActiveCnt() / PAGE_SIZE).
 	 */
 	Entity getEntity(Component* component);
 
@@ -116,23 +234,122 @@ public:
 	inline int getActiveCnt() { return cnt; } 
 
 	/**
-	 * @brief Get the last time the component container resize the vector containing all the components.
+	 * @brief Get the position of an entity's component in the dense array of components.
 	 * 
-	 * @return int an increment value that shows when the last reallocated time is. It starts at 0 and increase by 1 every time a rellocation happens. 
-	 * When reallocation happens, all pointers to previous components drop.
+	 * @param entity 
+	 * @return std::uint32_t the index, or SparseSet::NULL_INDEX if the entity does not have this component.
+	 */
+	inline std::uint32_t getIndex(const Entity entity) const { return entities.find(entity); }
+
+	/**
+	 * @param index an index in the range [0, getActiveCnt()).
+	 * @return Component& the component at that position of the dense array.
 	 */
-	int getLastReallocated() override { return lastReallocated; }
+	inline Component& at(std::uint32_t index) { return pages[index / PAGE_SIZE].get()[index % PAGE_SIZE]; }
+	inline const Component& at(std::uint32_t index) const { return pages[index / PAGE_SIZE].get()[index % PAGE_SIZE]; }
+
+	/**
+	 * @param index an index in the range [0, getActiveCnt()).
+	 * @return Entity the entity owning the component at that position of the dense array.
+	 */
+	inline Entity getEntityAt(std::uint32_t index) const { return entities.at(index); }
+
+	/**
+	 * @return const SparseSet& the entities with this component, in the same order as their components.
+	 */
+	inline const SparseSet& getEntities() const { return entities; }
+
+	/**
+	 * @brief Swap the position of two components in the dense array, along with the entities that own them.
+	 * Used by packed groups to keep their members at the front of the container. This drops all pointers to components.
+	 * 
+	 * @param indexA 
+	 * @param indexB 
+	 */
+	void swapComponents(std::uint32_t indexA, std::uint32_t indexB);
+
+	/**
+	 * @brief Call a function on every component, in parallel across the JobSystem's threads. 
+	 * The components are split into chunks that start on cache line boundaries, so that threads do not write to the same cache line.
+	 * No component of this type can be added or removed until this returns.
+	 * 
+	 * @tparam Function callable with a Component&.
+	 * @param jobs 
+	 * @param function 
+	 */
+	template <typename Function>
+	void parallelEach(JobSystem& jobs, Function&& function);
+
+	/**
+	 * @brief Forbid adding, removing, or reordering components until unlockStructure() is called. 
+	 * Locks nest, and breaking them is caught by a debug assert.
+	 */
+	void lockStructure() { structureLocks++; }
+
+	/**
+	 * @brief Release a lock taken with lockStructure().
+	 */
+	void unlockStructure() { structureLocks--; }
+
+	/**
+	 * @brief Start a batch of structural changes. Pages for the incoming components are allocated up front,
+	 * and no page is released until endBatch().
+	 * 
+	 * @param incoming the number of components about to be emplaced.
+	 */
+	void beginBatch(std::size_t incoming);
+
+	/**
+	 * @brief End a batch of structural changes, releasing pages if the batch left several of them empty.
+	 */
+	void endBatch();
+
+	/**
+	 * @brief Release every page that holds no component. Components never move, so this is safe to call at any time, 
+	 * but pages released here will have to be allocated again as the container grows. Call it when the container is not expected to grow soon, such as after loading a level.
+	 */
+	void compact();
+
+	/**
+	 * @return std::size_t the number of components the allocated pages can hold.
+	 */
+	std::size_t capacity() const { return pages.size() * PAGE_SIZE; }
+
+	/**
+	 * @brief Get the last time components changed position inside the container, either from being removed or swapped.
+	 * Allocating or releasing pages does not count, so indices from getIndex() and pointers to components stay valid until this value changes.
+	 * Even then, only the components that were moved are affected.
+	 * 
+	 * @return int an increment value that starts at 0 and increases by 1 every time components are reordered.
+	 */
+	int getLastReordered() override { return lastReordered; }
 private:
-	// lets goo
-	std::vector<Component> components;
-	std::unordered_map<Entity, size_t> componentMap; //!< map between Entity and which index its component is located at.
-	std::unordered_map<size_t, Entity> entityMap; //!< map between index and which entity the component at that index belongs to.
-	int cnt = 0; //!< number of active components
-	int lastReallocated = 0; //!< time at which the last reallocation happens
+	/**
+	 * @brief Releases the memory of a page, without destroying anything in it.
+	 */
+	struct PageDeleter {
+		void operator()(Component* page) const { std::allocator<Component>().deallocate(page, PAGE_SIZE); }
+	};
+	using Page = std::unique_ptr<Component, PageDeleter>; //!< uninitialized memory for PAGE_SIZE components.
+
+	std::vector<Page> pages; //!< the component at index i lives in page i / PAGE_SIZE. Only the first cnt slots hold a live component.
+	SparseSet entities; //!< entities with this component. The entity at index i of the set owns the component at index i of the storage.
+	std::uint32_t cnt = 0; //!< number of active components
+	int lastReordered = 0; //!< time at which components last changed index
+	bool batching = false; //!< whether a batch is in progress, during which no page is released.
+	std::atomic<int> structureLocks = 0; //!< number of parallel iterations in progress, during which components cannot move.
+
+	void onEntitiesDestroyed(std::span<const Entity> destroyed) override;
+
+	/**
+	 * @brief Allocate pages until the storage can hold a number of components.
+	 * 
+	 * @param size 
+	 */
+	void reserve(std::size_t size);
 
-	void onEntityDestroyed(Entity entity) override;
 	/**
-	 * @brief Readjust the size of the component vector. This should not affect any of the maps, and should have amortized O(1) performance.
+	 * @brief Release empty pages at the back of the storage, as long as more than one of them is empty. Never moves any component.
 	 */
 	void tryRepack();
 };
@@ -1,41 +1,59 @@
 #pragma once
 
 #include "componentContainer.h"
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <utility>
 #include "../_Core/asserts.h"
 
 namespace Saga {
 
 template <typename Component>
-typename std::vector<Component>::iterator ComponentContainer<Component>::begin() { return components.begin(); }
-
-template <typename Component>
-typename std::vector<Component>::iterator ComponentContainer<Component>::end() { return components.begin() + cnt; }
-
-template <typename Component>
-typename std::vector<Component>::const_iterator ComponentContainer<Component>::begin() const { return components.begin(); }
-
-template <typename Component>
-typename std::vector<Component>::const_iterator ComponentContainer<Component>::end() const { return components.begin() + cnt; }
+ComponentContainer<Component>::~ComponentContainer() {
+	for (std::uint32_t index = 0; index < cnt; index++)
+		std::destroy_at(&at(index));
+}
 
 template <typename Component>
 template <typename... Args>
 Component* ComponentContainer<Component>::emplace(const Entity entity, Args &&...args) {
-    int index = cnt++;
-	// repack if not enough space
-    while (index >= components.size()) tryRepack();
-    components[index] = Component(args...);
+	SASSERT_DEBUG_MESSAGE(!entities.contains(entity), "Entity already has a component of the same type attached. You cannot have multiple of the same component type attached to the same entity.");
+	SASSERT_DEBUG_MESSAGE(!structureLocks, "Trying to emplace a component while its container is being iterated in parallel. Use the world's CommandBuffer instead.");
 
-	SASSERT_DEBUG_MESSAGE(!componentMap.count(entity), "Entity already has a component of the same type attached. You cannot have multiple of the same component type attached to the same entity.");
+	// growing only adds a page, so no other component moves
+	std::uint32_t index = cnt;
+	reserve(index + 1);
+	::new (static_cast<void*>(&at(index))) Component(std::forward<Args>(args)...);
+	cnt++;
 
-	// adjust the relevant maps
-	componentMap[entity] = index;
-	entityMap[index] = entity;
+	// the entity lands at the back of the set, which lines up with index
+	entities.insert(entity);
+	addedTicks.push_back(currentTick);
+	changedTicks.push_back(currentTick);
 
-	tryRepack();
+	return &at(index);
+}
 
-	return &components[index];
+template <typename Component>
+template <typename... Args>
+void ComponentContainer<Component>::emplaceBulk(std::span<const Entity> targets, const Args &...args) {
+	SASSERT_DEBUG_MESSAGE(!structureLocks, "Trying to emplace components while their container is being iterated in parallel. Use the world's CommandBuffer instead.");
+
+	// everything is sized once, then the components are constructed back to back
+	std::size_t first = cnt;
+	reserve(first + targets.size());
+	entities.reserve(first + targets.size());
+	for (std::size_t i = 0; i < targets.size(); i++) {
+		SASSERT_DEBUG_MESSAGE(!entities.contains(targets[i]), "Entity already has a component of the same type attached. You cannot have multiple of the same component type attached to the same entity.");
+		::new (static_cast<void*>(&at(first + i))) Component(args...);
+		entities.insert(targets[i]);
+	}
+	cnt += targets.size();
+	addedTicks.resize(cnt, currentTick);
+	changedTicks.resize(cnt, currentTick);
 }
 
 template <typename Component>
@@ -46,80 +64,148 @@ std::optional<Component*> ComponentContainer<Component>::any() {
 
 template <typename Component>
 Component* ComponentContainer<Component>::getComponent(const Entity entity) {
-	if (!componentMap.count(entity)) return nullptr;
-	int index = componentMap[entity];
-    return &components[index];
+	std::uint32_t index = entities.find(entity);
+	if (index == SparseSet::NULL_INDEX) return nullptr;
+    return &at(index);
 }
 
 template <typename Component>
 bool ComponentContainer<Component>::hasComponent(const Entity entity) {
-	return componentMap.count(entity);
+	return entities.contains(entity);
 }
 
 template <typename Component>
 Entity ComponentContainer<Component>::getEntity(Component* component) {
-	// find an iterator to the position in the vertex with the same component pointer
-    auto iter = std::find_if(components.begin(), components.end(), [&](Component& value) {
-		return &value == component; // compare pointers
-	});
-	if (iter != components.end()) {
-		int index = iter - components.begin(); // we can find index this way because we use a vector
-		return entityMap[index];
+	// components are stored contiguously within a page, so the pointer offset inside its page gives the index into the set
+	for (std::uint32_t page = 0; page * PAGE_SIZE < cnt; page++) {
+		Component* first = pages[page].get();
+		if (component < first || component >= first + PAGE_SIZE) continue;
+		std::uint32_t index = page * PAGE_SIZE + (component - first);
+		if (index < cnt) return entities.at(index);
+		break;
 	}
-    return (Entity) -1; // if entity not found
+	return (Entity) -1; // if entity not found
 }
 
 template <typename Component>
-void ComponentContainer<Component>::onEntityDestroyed(Entity entity) {
-	removeComponent(entity);
+void ComponentContainer<Component>::onEntitiesDestroyed(std::span<const Entity> destroyed) {
+	if (cnt == 0) return;
+	SASSERT_DEBUG_MESSAGE(!structureLocks, "Trying to remove components while their container is being iterated in parallel. Use the world's CommandBuffer instead.");
+
+	// when the whole container goes, nothing needs to be moved into the holes. The entities are unique, so counting them is enough.
+	if (destroyed.size() >= cnt && cnt == std::size_t(std::count_if(destroyed.begin(), destroyed.end(), 
+			[&](Entity entity) { return entities.contains(entity); }))) {
+		for (std::uint32_t i = 0; i < cnt; i++) std::destroy_at(&at(i));
+		entities.clear();
+		addedTicks.clear();
+		changedTicks.clear();
+		lastReordered++;
+		cnt = 0;
+		tryRepack();
+		return;
+	}
+
+	// swap-remove each of them, releasing pages once at the end
+	batching = true;
+	for (Entity entity : destroyed) removeComponent(entity);
+	batching = false;
+	tryRepack();
 }
 
 template <typename Component>
 void ComponentContainer<Component>::removeComponent(const Entity entity) {
-	if (!componentMap.count(entity)) return;
-
-    int componentIndex = componentMap[entity];
-	// first remove the entity
+	std::uint32_t componentIndex = entities.find(entity);
+	if (componentIndex == SparseSet::NULL_INDEX) return;
+	SASSERT_DEBUG_MESSAGE(!structureLocks, "Trying to remove a component while its container is being iterated in parallel. Use the world's CommandBuffer instead.");
+
+	SASSERT_MESSAGE(cnt > 0, "Number of components decreased below 0. This should not be possible.");
+
+	// this deletion creates a hole in our component list, we want to adjust that by 
+	// moving the last entity + component to this hole index. The set does the same for the entity.
+	std::destroy_at(&at(componentIndex));
+	if (componentIndex != cnt-1) {
+        STRACE("moved %d to %d", cnt-1, componentIndex);
+		::new (static_cast<void*>(&at(componentIndex))) Component(std::move(at(cnt-1)));
+		std::destroy_at(&at(cnt-1));
+		addedTicks[componentIndex] = addedTicks.back();
+		changedTicks[componentIndex] = changedTicks.back();
+	}
+	entities.remove(entity);
+	addedTicks.pop_back();
+	changedTicks.pop_back();
 
-	SASSERT_MESSAGE(cnt >= 0, "Number of components decreased below 0. This should not be possible.");
+	// signal that the last component may have moved, along with its pointer and index
+	lastReordered++;
+    cnt--;
 
-	if (cnt > 0) {
-		// this deletion creates a hole in our component list, we want to adjust that by 
-		// swapping the last entity + component to this hole index
-		Entity entityLast = entityMap[cnt-1];
+	// repack, if too big
+	tryRepack();
+}
 
-		// and adjust the corresponding maps
-		componentMap[entityLast] = componentIndex;
-		entityMap[componentIndex] = entityLast;
+template <typename Component>
+void ComponentContainer<Component>::swapComponents(std::uint32_t indexA, std::uint32_t indexB) {
+	if (indexA == indexB) return;
+	SASSERT_DEBUG_MESSAGE(!structureLocks, "Trying to reorder components while their container is being iterated in parallel.");
+	// done through move construction, so that components need not be assignable
+	Component temp(std::move(at(indexA)));
+	std::destroy_at(&at(indexA));
+	::new (static_cast<void*>(&at(indexA))) Component(std::move(at(indexB)));
+	std::destroy_at(&at(indexB));
+	::new (static_cast<void*>(&at(indexB))) Component(std::move(temp));
+	entities.swap(indexA, indexB);
+	std::swap(addedTicks[indexA], addedTicks[indexB]);
+	std::swap(changedTicks[indexA], changedTicks[indexB]);
+	lastReordered++;
+}
 
-        STRACE("swapped %d %d", cnt-1, componentIndex);
-        std::swap(components[cnt-1], components[componentIndex]);
+template <typename Component>
+template <typename Function>
+void ComponentContainer<Component>::parallelEach(JobSystem& jobs, Function&& function) {
+	lockStructure();
+	EventSource loop = EventQueue::beginLoop();
+	jobs.parallelForChunks(0, cnt, [&](std::size_t chunkBegin, std::size_t chunkEnd) { 
+		EventQueue::Source source(loop, chunkBegin);
+		for (std::size_t index = chunkBegin; index < chunkEnd; index++) function(at(index)); 
+	}, 
+		std::max<std::size_t>(1, CACHE_LINE_SIZE / sizeof(Component)));
+	unlockStructure();
+}
 
-        // signal that pointers are bad
-        lastReallocated++;
-	}
+template <typename Component>
+void ComponentContainer<Component>::beginBatch(std::size_t incoming) {
+	reserve(cnt + incoming);
+	addedTicks.reserve(cnt + incoming);
+	changedTicks.reserve(cnt + incoming);
+	batching = true;
+}
 
+template <typename Component>
+void ComponentContainer<Component>::endBatch() {
+	batching = false;
+	tryRepack();
+}
 
-	componentMap.erase(entity); 
-	entityMap.erase(cnt-1); // and decrement the size
-    cnt--;
+template <typename Component>
+void ComponentContainer<Component>::compact() {
+	pages.resize((cnt + PAGE_SIZE - 1) / PAGE_SIZE);
+	pages.shrink_to_fit();
+	addedTicks.shrink_to_fit();
+	changedTicks.shrink_to_fit();
+}
 
-	// repack, if too big
-	tryRepack();
+template <typename Component>
+void ComponentContainer<Component>::reserve(std::size_t size) {
+	while (capacity() < size)
+		pages.emplace_back(std::allocator<Component>().allocate(PAGE_SIZE));
 }
 
 template <typename Component>
 void ComponentContainer<Component>::tryRepack() {
-	// half the size if more than 3/4 of the vector is unused
-	if (components.size() > 4 * cnt) {
-		components.resize(cnt*2);
-		lastReallocated++;
-	} 
-	// double the size if about to overflow
-	else if (components.size() <= cnt) {
-		components.resize(cnt*2);
-		lastReallocated++;
-	}
+	// keep one empty page as slack, so that hovering around a page boundary does not allocate and release over and over.
+	// During a batch, the storage was sized up front, so hold off until it ends.
+	std::size_t usedPages = (cnt + PAGE_SIZE - 1) / PAGE_SIZE;
+	if (!batching && pages.size() > usedPages + 1)
+		pages.resize(usedPages + 1);
 }
 
 } // namespace Saga
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <vector>
-#include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include "../Entity/entity.h"
+#include "../Datastructures/sparseSet.h"
+#include "../Datastructures/typeOrder.h"
 #include "gameworld.h"
-#include "componentReference.h"
+#include "componentContainer.h"
 
 namespace Saga {
 
@@ -20,30 +27,120 @@ public:
 	virtual ~IComponentGroup() = default;
 	/**
 	 * @brief Handle adding an entity to a group. This entity must have all the components specified by the group
-	 * 
-	 * @param world 
-	 * @param entity 
+	 *
+	 * @param world
+	 * @param entity
+	 */
+	virtual void addEntity(GameWorld& world, const Entity& entity) = 0;
+
+	/**
+	 * @brief Handle adding several entities to a group at once. Every entity must have all the components specified by the group.
+	 *
+	 * @param world
+	 * @param entities
 	 */
-	virtual void addEntity(std::shared_ptr<GameWorld> world, const Entity& entity) = 0;
+	virtual void addEntities(GameWorld& world, std::span<const Entity> entities) = 0;
 
 	/**
 	 * @brief Handle removing an entity from a group.
-	 * 
-	 * @param entity 
+	 *
+	 * @param entity
 	 */
 	virtual void removeEntity(Entity entity) = 0;
+
+protected:
+	static inline std::atomic_int slotCount{0}; //!< Used for assigning a slot to each type of group.
 };
 
 /**
- * @brief Effectively a list of tuples each entry containing an Entity and ComponentReference to each of the component type in the group.
+ * @brief The ComponentGroup that stores the entities with a set of components. Every order of the same components maps to the same group.
+ *
+ * @tparam Component the components, in any order.
+ */
+template <typename... Component>
+using CanonicalGroup = typename SortedTypes<Component...>::template As<ComponentGroup>;
+
+/**
+ * @brief Effectively a list of tuples each entry containing an Entity and a pointer to each of the component type in the group.
  * These Entity must have the specified components, or else there will be unexpected behaviour.
  * When an Entity no longer has all the required components, it must be removed from the Group.
- * 
- * @tparam Component a list of components all entities in the Group shares. This list must be in @em alphabetical order.
+ *
+ * A group has one of two storage modes (see GroupStorage). A Referenced group stores, for each entity, the index of each of its components
+ * inside their containers. These indices are refreshed in bulk when iteration begins, only if a container has reordered its components since.
+ * A Packed group owns the containers of its components instead: its members are kept at the front of every one of those containers,
+ * all in the same order, so iterating the group walks each component array linearly.
+ * Either way, iteration yields plain pointers. For long-lived handles to a component, use ComponentReference.
+ *
+ * Tags (see isTag) are not stored, so a group yields the same shared instance for them, and a Packed group only orders the containers of its other components.
+ *
+ * Only the CanonicalGroup of a set of components stores entities. A group listing the same components in another order 
+ * is a view of it, which yields the components in its own order.
+ *
+ * @tparam Component a list of components all entities in the Group shares, in any order.
  */
 template <typename... Component>
 class ComponentGroup : public IComponentGroup {
+	using Indices = std::array<std::uint32_t, sizeof...(Component)>; //!< position of each of an entity's components inside their containers.
+	using Canonical = CanonicalGroup<Component...>;
+	template <typename... Other> friend class ComponentGroup;
 public:
+	static constexpr bool isCanonical = std::is_same_v<ComponentGroup, Canonical>; //!< whether this group stores entities, instead of viewing another group.
+	static constexpr std::size_t anchorColumn = [] {
+		constexpr std::array<bool, sizeof...(Component)> tags = { isTag<Component>... };
+		for (std::size_t column = 0; column < tags.size(); column++)
+			if (!tags[column]) return column;
+		return tags.size();
+	}(); //!< the first component that is not a tag. Packed groups find their members' index in its container.
+
+	/**
+	 * @brief Iterates through the group, yielding a tuple of the Entity and a pointer to each of its components.
+	 * The pointers are only valid until components of these types are added or removed from the world.
+	 */
+	class iterator {
+	public:
+		using value_type = std::tuple<Entity, Component*...>;
+
+		iterator(ComponentGroup* group, std::size_t index) : group(group), index(index) {}
+
+		/**
+		 * @return value_type& the entry the iterator points to. This lives inside the iterator.
+		 */
+		value_type& operator*();
+		iterator& operator++() { index++; return *this; }
+		bool operator==(const iterator& other) const { return index == other.index; }
+		bool operator!=(const iterator& other) const { return index != other.index; }
+
+	private:
+		ComponentGroup* group;
+		std::size_t index;
+		value_type current; //!< the entry being pointed to, refreshed on dereference.
+	};
+
+	/**
+	 * @brief Construct an empty Referenced Component Group that is not attached to any world.
+	 */
+	ComponentGroup() {
+		if constexpr (!isCanonical) source = std::make_shared<Canonical>();
+	}
+
+	/**
+	 * @brief Construct a view of the group that stores these components in another order.
+	 *
+	 * @param source the CanonicalGroup of these components.
+	 */
+	explicit ComponentGroup(std::shared_ptr<Canonical> source) : source(source) {
+		static_assert(!isCanonical, "A canonical group stores its own entities.");
+	}
+
+	/**
+	 * @brief Construct a new Component Group.
+	 *
+	 * @param storage how the group stores its entities. A Packed group takes ownership of the order of components inside each container.
+	 * @param containers the containers of each of the group's components.
+	 */
+	ComponentGroup(GroupStorage storage, std::shared_ptr<ComponentContainer<Component>>... containers)
+		: storage(storage), containers(containers...) {}
+
 	/**
 	 * @brief Destroy the Component Group object.
 	 */
@@ -51,35 +148,113 @@ public:
 
 	/**
 	 * @brief Add an Entity to the Group. This entity must contain all the required components. If such an entity already exists in the group, do nothing.
-	 * 
-	 * @param world 
-	 * @param entity 
+	 *
+	 * @param world
+	 * @param entity
+	 */
+	virtual void addEntity(GameWorld& world, const Entity& entity) override;
+
+	/**
+	 * @brief Add several entities to the Group at once, reserving room for all of them up front. Entities the group already has are skipped.
+	 *
+	 * @param world
+	 * @param entities
 	 */
-	virtual void addEntity(std::shared_ptr<GameWorld> world, const Entity& entity) override;
+	virtual void addEntities(GameWorld& world, std::span<const Entity> entities) override;
 
 	/**
 	 * @brief Remove an entity from the ComponentGroup.
-	 * 
-	 * @param entity 
+	 *
+	 * @param entity
 	 */
 	virtual void removeEntity(Entity entity) override;
 
-	typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::iterator begin();
-	typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::iterator end();
-    typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::const_iterator begin() const;
-    typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::const_iterator end() const;
-private:
-    std::vector<std::tuple<Entity, ComponentReference<Component>...>> allData; //!< list of all entities and references to their components
-	std::unordered_map<Entity, size_t> entityToIndex; //!< map between entity and index into allData where the entity lies
+	/**
+	 * @return std::size_t number of entities in the group.
+	 */
+	std::size_t size() const;
 
 	/**
-	 * @brief Create an entity-references tuple for a specific entity
+	 * @return GroupStorage how this group stores its entities.
+	 */
+	GroupStorage getStorage() const;
+
+	/**
+	 * @brief Get the slot of this type of group. Every type of group has a different slot, which worlds use to cache their groups.
+	 *
+	 * @return int 
+	 */
+	static int getSlot() {
+		static int slot = slotCount++;
+		return slot;
+	}
+
+	/**
+	 * @brief Call a function on every entry of the group, in parallel across the JobSystem's threads. 
+	 * Entries are split into chunks aligned to cache lines of the group's arrays.
+	 * No component of the group's types can be added or removed until this returns.
 	 * 
-	 * @param world 
-	 * @param entity 
-	 * @return std::tuple<Entity, ComponentReference<Component>...> the first component is the entity, and the rest are references to the components specified by the Group, in the order in which they are specified.
+	 * @tparam Function callable with an Entity and a pointer to each of the group's components, like the entries yielded by iteration.
+	 * @param jobs 
+	 * @param function 
+	 */
+	template <typename Function>
+	void parallelEach(JobSystem& jobs, Function&& function);
+
+	/**
+	 * @brief Start iterating through the group. This first brings the stored indices up to date if any container has been reordered.
+	 */
+	iterator begin();
+	iterator end() { return iterator(this, size()); }
+private:
+	GroupStorage storage = GroupStorage::Referenced;
+	std::tuple<std::shared_ptr<ComponentContainer<Component>>...> containers; //!< containers of each component.
+	std::size_t packedSize = 0; //!< for Packed groups, the first packedSize components in each container belong to the group.
+
+	SparseSet members; //!< for Referenced groups, all entities in the group.
+	std::vector<Indices> indices; //!< for Referenced groups, indices[i] locates the components of the entity at members.at(i).
+	std::array<int, sizeof...(Component)> lastReordered = {}; //!< the containers' getLastReordered() at the time indices was last refreshed.
+	std::mutex refreshMutex; //!< Systems running in parallel may begin iterating the same group at the same time.
+	std::shared_ptr<Canonical> source; //!< for views, the group that stores the entities.
+
+	/**
+	 * @param container the container of one of the group's components.
+	 * @param entity an entity that has that component.
+	 * @return std::uint32_t the index of the entity's component inside the container, or 0 for tags, which are not stored.
+	 */
+	template <typename C>
+	static std::uint32_t indexIn(ComponentContainer<C>& container, Entity entity) {
+		if constexpr (isTag<C>) return 0;
+		else return container.getIndex(entity);
+	}
+
+	/**
+	 * @brief Swap two components inside a container, unless the component is a tag, which is not stored.
+	 *
+	 * @param container the container of one of the group's components.
+	 * @param a
+	 * @param b
+	 */
+	template <typename C>
+	static void swapIn(ComponentContainer<C>& container, std::uint32_t a, std::uint32_t b) {
+		if constexpr (!isTag<C>) container.swapComponents(a, b);
+	}
+
+	/**
+	 * @brief Recompute the stored indices of any container that has reordered its components since the last refresh.
+	 */
+	void refreshIndices();
+
+	/**
+	 * @brief Bring the stored indices up to date before reading entries.
+	 */
+	void prepare();
+
+	/**
+	 * @param index an index in the range [0, size()).
+	 * @return typename iterator::value_type the entry at that index. The stored indices must be up to date.
 	 */
-	std::tuple<Entity, ComponentReference<Component>...> createTuple(std::shared_ptr<GameWorld> world, const Entity& entity);
+	typename iterator::value_type getEntry(std::size_t index);
 };
 
 } // namespace Saga
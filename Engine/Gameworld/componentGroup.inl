@@ -2,54 +2,186 @@
 
 #include "componentGroup.h"
 #include <type_traits>
+#include <algorithm>
 #include <utility>
 #include "../_Core/logger.h"
 
 namespace Saga {
 
 template <typename... Component>
-void ComponentGroup<Component...>::addEntity(std::shared_ptr<GameWorld> world, const Entity& entity) {
-	if (entityToIndex.count(entity)) {
+void ComponentGroup<Component...>::addEntity(GameWorld& world, const Entity& entity) {
+	if constexpr (!isCanonical) return source->addEntity(world, entity);
+
+	if constexpr (anchorColumn < sizeof...(Component)) {
+		if (storage == GroupStorage::Packed) {
+			std::uint32_t index = std::get<anchorColumn>(containers)->getIndex(entity);
+			if (index < packedSize) {
+				SWARN("Trying to add an entity %d to group, but this group already has it.", entity);
+				return;
+			}
+			// move the entity's components to just past the end of the packed range in every container
+			std::apply([&](auto&... container) {
+				(swapIn(*container, indexIn(*container, entity), packedSize), ...);
+			}, containers);
+			packedSize++;
+			return;
+		}
+	}
+
+	if (members.contains(entity)) {
 		SWARN("Trying to add an entity %d to group, but this group already has it.", entity);
 		return;
 	}
 
-	allData.emplace_back(std::move(createTuple(world, entity)));
-	entityToIndex[entity] = allData.size()-1;
+	members.insert(entity);
+	indices.push_back(std::apply([&](auto&... container) {
+		return Indices{ indexIn(*container, entity)... };
+	}, containers));
+}
+
+template <typename... Component>
+void ComponentGroup<Component...>::addEntities(GameWorld& world, std::span<const Entity> entities) {
+	if constexpr (!isCanonical) return source->addEntities(world, entities);
+
+	// packed members are moved into place one by one, but referenced groups can size their lists once
+	if (storage == GroupStorage::Referenced) {
+		members.reserve(members.size() + entities.size());
+		indices.reserve(indices.size() + entities.size());
+	}
+	for (Entity entity : entities) addEntity(world, entity);
 }
 
 template <typename... Component>
 void ComponentGroup<Component...>::removeEntity(Entity entity) {
-	if (!entityToIndex.count(entity)) {
+	if constexpr (!isCanonical) return source->removeEntity(entity);
+
+	if constexpr (anchorColumn < sizeof...(Component)) {
+		if (storage == GroupStorage::Packed) {
+			std::uint32_t index = std::get<anchorColumn>(containers)->getIndex(entity);
+			if (index >= packedSize) {
+				SWARN("Trying to remove an entity %d from group, but this group does not have it.", entity);
+				return;
+			}
+			// members share the same index in every container, so we move them all to the back of the packed range
+			packedSize--;
+			std::apply([&](auto&... container) {
+				(swapIn(*container, index, packedSize), ...);
+			}, containers);
+			return;
+		}
+	}
+
+	if (!members.contains(entity)) {
 		SWARN("Trying to remove an entity %d from group, but this group does not have it.", entity);
 		return;
 	}
-	int indexToRemove = entityToIndex[entity];
-	Entity entityToReplace = get<0>(allData.back());
 
-	// removing this in place will create a hole in our vector of tuples, so we swap with the back element, and then remove
-	std::swap(allData[indexToRemove], allData[allData.size()-1]);
-	entityToIndex[entityToReplace] = indexToRemove;
-	entityToIndex.erase(entity);
-	allData.pop_back();
+	// removing this in place will create a hole, so the set swaps with the back element. We mirror that on the indices.
+	std::uint32_t indexToRemove = members.remove(entity);
+	indices[indexToRemove] = indices.back();
+	indices.pop_back();
 }
 
 template <typename... Component>
-std::tuple<Entity, ComponentReference<Component>...> ComponentGroup<Component...>::createTuple(
-	std::shared_ptr<GameWorld> world, const Entity& entity) {
-    return std::make_tuple(entity, world->getComponent<Component>(entity)...);
+std::size_t ComponentGroup<Component...>::size() const {
+	if constexpr (!isCanonical) return source->size();
+	return storage == GroupStorage::Packed ? packedSize : members.size();
 }
 
 template <typename... Component>
-typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::iterator ComponentGroup<Component...>::begin() { return allData.begin();}
+GroupStorage ComponentGroup<Component...>::getStorage() const {
+	if constexpr (!isCanonical) return source->getStorage();
+	return storage;
+}
 
 template <typename... Component>
-typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::iterator ComponentGroup<Component...>::end() { return allData.end();}
+typename ComponentGroup<Component...>::iterator ComponentGroup<Component...>::begin() {
+	prepare();
+	return iterator(this, 0);
+}
 
 template <typename... Component>
-typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::const_iterator ComponentGroup<Component...>::begin() const { return allData.begin();}
+void ComponentGroup<Component...>::prepare() {
+	if constexpr (!isCanonical) return source->prepare();
+
+	if (storage == GroupStorage::Referenced && members.size()) {
+		std::lock_guard<std::mutex> lock(refreshMutex);
+		refreshIndices();
+	}
+}
 
 template <typename... Component>
-typename std::vector<std::tuple<Entity, ComponentReference<Component>...>>::const_iterator ComponentGroup<Component...>::end() const { return allData.end();}
+template <typename Function>
+void ComponentGroup<Component...>::parallelEach(JobSystem& jobs, Function&& function) {
+	if constexpr (!isCanonical) {
+		// the source yields components in its own order, so we pick ours back out by type
+		return source->parallelEach(jobs, [&](Entity entity, auto*... component) {
+			auto entry = std::make_tuple(component...);
+			function(entity, std::get<Component*>(entry)...);
+		});
+	}
+
+	if (!size()) return;
+	prepare();
+
+	// chunks should not share a cache line in whichever array has the smallest elements
+	std::size_t grain = std::max({std::size_t(1), CACHE_LINE_SIZE / sizeof(Indices), (isTag<Component> ? std::size_t(1) : CACHE_LINE_SIZE / sizeof(Component))...});
+
+	std::apply([](auto&... container) { (container->lockStructure(), ...); }, containers);
+	EventSource loop = EventQueue::beginLoop();
+	jobs.parallelForChunks(0, size(), [&](std::size_t chunkBegin, std::size_t chunkEnd) { 
+		EventQueue::Source source(loop, chunkBegin);
+		for (std::size_t index = chunkBegin; index < chunkEnd; index++) std::apply(function, getEntry(index)); 
+	}, grain);
+	std::apply([](auto&... container) { (container->unlockStructure(), ...); }, containers);
+}
+
+template <typename... Component>
+void ComponentGroup<Component...>::refreshIndices() {
+	[&]<std::size_t... column>(std::index_sequence<column...>) {
+		([&] {
+			if constexpr (isTag<std::tuple_element_t<column, std::tuple<Component...>>>) return;
+			auto& container = std::get<column>(containers);
+			if (container->getLastReordered() == lastReordered[column]) return;
+			for (std::size_t i = 0; i < indices.size(); i++)
+				indices[i][column] = container->getIndex(members.at(i));
+			lastReordered[column] = container->getLastReordered();
+		}(), ...);
+	}(std::index_sequence_for<Component...>{});
+}
+
+template <typename... Component>
+typename ComponentGroup<Component...>::iterator::value_type ComponentGroup<Component...>::getEntry(std::size_t index) {
+	if constexpr (!isCanonical) {
+		auto entry = source->getEntry(index);
+		return typename iterator::value_type(std::get<Entity>(entry), std::get<Component*>(entry)...);
+	}
+
+	// tags are not stored, so every entity shares the same instance
+	auto component = []<typename C>(ComponentContainer<C>& container, std::uint32_t componentIndex) -> C* {
+		if constexpr (isTag<C>) return &tagInstance<C>;
+		else return &container.at(componentIndex);
+	};
+
+	if constexpr (anchorColumn < sizeof...(Component)) {
+		if (storage == GroupStorage::Packed) {
+			// every container has this entry at the same index
+			return std::apply([&](auto&... container) {
+				return typename iterator::value_type(std::get<anchorColumn>(containers)->getEntityAt(index), component(*container, index)...);
+			}, containers);
+		}
+	}
+
+	const Indices& entry = indices[index];
+	return [&]<std::size_t... column>(std::index_sequence<column...>) {
+		return typename iterator::value_type(members.at(index), component(*std::get<column>(containers), entry[column])...);
+	}(std::index_sequence_for<Component...>{});
+}
+
+template <typename... Component>
+typename ComponentGroup<Component...>::iterator::value_type& ComponentGroup<Component...>::iterator::operator*() {
+	current = group->getEntry(index);
+	return current;
+}
 
 }
@@ -8,8 +8,15 @@
 
 namespace Saga {
 
+class GameWorld;
+
 /**
  * @brief Reference to a component. Will be valid as long as that component exists on a specific Entity, even if their pointer address has changed.
+ * The pointer to the component is cached. Containers never reallocate their components, so the cache only has to be checked when the container reorders components,
+ * and only needs refreshing if this component was among those that moved.
+ * 
+ * Going through the reference with operator->() or converting it to a pointer is a mutable access, and marks the component as changed.
+ * Systems that only read the component use get() instead, or access it through a const reference.
  * 
  * @tparam Component type of component this reference is for.
  */
@@ -34,20 +41,54 @@ public:
 	 */
 	virtual ~ComponentReference() {};
 
+	/**
+	 * @brief Get a volatile pointer to the component this references, without marking it as changed.
+	 * 
+	 * @return const Component* pointer to the component, or nullptr if none exists.
+	 */
+	const Component* get() const { return getVolatile(); }
+
+	/**
+	 * @brief Get a volatile pointer to the component this references, and mark the component as changed.
+	 * 
+	 * @return Component* pointer to the component, or nullptr if none exists.
+	 */
+	Component* getMutable() {
+		Component* component = getVolatile();
+		if (component) componentContainer->markChanged(cachedIndex);
+		return component;
+	}
+
 	/**
 	 * @brief Get a volatile pointer to the component this references. 
 	 * Since this pointer can change when components of the same type are added and removed from the world, it is not a good idea to use this pointer for a long time.
+	 * This is a mutable access, so the component is marked as changed.
 	 * 
 	 * @return Component* a reference to the component, or nullptr if none exists.
 	 */
-    operator Component*() { return getVolatile(); }
+    operator Component*() { return getMutable(); }
 
 	/**
 	 * @brief Automatic cast of ComponentReference to their volatile Component pointer form.
+	 * This is a mutable access, so the component is marked as changed.
 	 * 
 	 * @return Component* pointer to the component that this object references, or nullptr if they don't exist.
 	 */
-    Component* operator->() { return getVolatile(); }
+    Component* operator->() { return getMutable(); }
+
+	/**
+	 * @brief Read access through a const reference. The component is not marked as changed.
+	 * 
+	 * @return const Component* pointer to the component that this object references, or nullptr if they don't exist.
+	 */
+    const Component* operator->() const { return get(); }
+
+	/**
+	 * @brief Read access through a const reference. The component is not marked as changed.
+	 * 
+	 * @return const Component* pointer to the component, or nullptr if none exists.
+	 */
+    operator const Component*() const { return get(); }
 
     /**
      * @brief Get the entity this component is on.
@@ -55,15 +96,17 @@ public:
      * @return entity if this is not a null reference.
      * @return nothing otherwise.
      */
-    std::optional<Entity> getEntity() {
+    std::optional<Entity> getEntity() const {
         if (!getVolatile()) return {};
         return entity;
     }
 
 private:
-	// will be wonky behaviour if you encounter the ABA problem. But if you do it's not really the engine's fault is it
-	int lastReallocated = -1;
-	Component* cachedComponent = nullptr; //!< a cached pointer to the component. Will be valid as long as the container has not reallocated its memory.
+	// entities carry a generation, so a reference to a destroyed entity stays null even after its slot is recycled.
+	// the cache is refreshed on reads too, so it is mutable. A reference is owned by one thread, like any other component data.
+	mutable int lastReordered = -1; //!< the container's getLastReordered() when the cache was last checked.
+	mutable std::uint32_t cachedIndex = SparseSet::NULL_INDEX; //!< index of the component inside its container.
+	mutable Component* cachedComponent = nullptr; //!< a cached pointer to the component. Will be valid as long as the component stays at cachedIndex.
 	std::shared_ptr<ComponentContainer<Component>> componentContainer;
 	Entity entity = (Entity) -1;
 
@@ -72,16 +115,79 @@ private:
 	 * 
 	 * @return Component* pointer to the component, nullptr if it does not exist.
 	 */
-    Component* getVolatile() {
+    Component* getVolatile() const {
 		if (!componentContainer) return nullptr;
-		// if reallocated, we need to fetch a new cache
-        if (componentContainer->getLastReallocated() > lastReallocated) {
-            cachedComponent = componentContainer->getComponent(entity);
-            lastReallocated = componentContainer->getLastReallocated();
+		// a missing component may have been added since, so only a valid cache can be trusted
+		if (cachedComponent && componentContainer->getLastReordered() == lastReordered) return cachedComponent;
+
+		// components were moved, but most likely not this one. Checking the slot is cheaper than looking the entity up.
+		if (cachedIndex >= (std::uint32_t) componentContainer->getActiveCnt() || componentContainer->getEntityAt(cachedIndex) != entity) {
+			cachedIndex = componentContainer->getIndex(entity);
+			cachedComponent = cachedIndex == SparseSet::NULL_INDEX ? nullptr : &componentContainer->at(cachedIndex);
 		}
+		lastReordered = componentContainer->getLastReordered();
 		return cachedComponent;
 	}
 };
 
+/**
+ * @brief Reference to a tag on an entity. Tags have no storage, so this asks the world whether the entity still has the tag.
+ * Unlike references to other components, it must not outlive its world.
+ * 
+ * @tparam Component a tag, see isTag.
+ */
+template <typename Component> requires isTag<Component>
+class ComponentReference<Component> {
+public:
+	/**
+	 * @brief Construct a new Component Reference object.
+	 */
+	ComponentReference() {}
+	/**
+	 * @brief Construct a new Component Reference object.
+	 * 
+	 * @param world 
+	 * @param entity 
+	 */
+	ComponentReference(GameWorld* world, Entity entity) : world(world), entity(entity) {}
+
+	/**
+	 * @return Component* the tag's shared instance if the entity has the tag, nullptr otherwise.
+	 */
+	operator Component*() { return get(); }
+
+	/**
+	 * @return Component* the tag's shared instance if the entity has the tag, nullptr otherwise.
+	 */
+	Component* operator->() { return get(); }
+
+	/**
+	 * @return Component* the tag's shared instance if the entity has the tag, nullptr otherwise.
+	 */
+	Component* get() const;
+
+	/**
+	 * @brief Same as get(). Tags have no data, so they are never marked as changed.
+	 * 
+	 * @return Component* the tag's shared instance if the entity has the tag, nullptr otherwise.
+	 */
+	Component* getMutable() const { return get(); }
+
+    /**
+     * @brief Get the entity this tag is on.
+     *
+     * @return entity if this is not a null reference.
+     * @return nothing otherwise.
+     */
+    std::optional<Entity> getEntity() const {
+        if (!get()) return {};
+        return entity;
+    }
+
+private:
+	GameWorld* world = nullptr;
+	Entity entity = (Entity) -1;
+};
+
 } // namespace Saga
 
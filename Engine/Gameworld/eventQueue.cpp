@@ -0,0 +1,71 @@
+#include "eventQueue.h"
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace Saga {
+
+namespace {
+	// what the calling thread is currently queuing events from
+	thread_local EventSource currentSource;
+	thread_local std::uint32_t currentLoops = 0; //!< parallel loops started from currentSource so far.
+}
+
+EventQueue::Source::Source(std::uint32_t system) : previous(currentSource), previousLoops(currentLoops) {
+	currentSource = EventSource{ .system = system };
+	currentLoops = 0;
+}
+
+EventQueue::Source::Source(const EventSource& loop, std::uint64_t index) : previous(currentSource), previousLoops(currentLoops) {
+	currentSource = loop;
+	currentSource.index = index;
+	currentLoops = 0;
+}
+
+EventQueue::Source::~Source() {
+	currentSource = previous;
+	currentLoops = previousLoops;
+}
+
+EventSource EventQueue::beginLoop() {
+	EventSource loop = currentSource;
+	loop.loop = ++currentLoops;
+	loop.counter = 0;
+	return loop;
+}
+
+EventQueue::~EventQueue() {
+	IQueuedEvent* queuedEvent = head.exchange(nullptr, std::memory_order_acquire);
+	while (queuedEvent) {
+		IQueuedEvent* next = queuedEvent->next;
+		delete queuedEvent;
+		queuedEvent = next;
+	}
+}
+
+void EventQueue::push(IQueuedEvent* queuedEvent) {
+	queuedEvent->source = currentSource;
+	currentSource.counter++;
+	queuedEvent->next = head.load(std::memory_order_relaxed);
+	while (!head.compare_exchange_weak(queuedEvent->next, queuedEvent, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void EventQueue::dispatch() {
+	// take the whole list at once. Anything queued from here on waits for the next dispatch
+	IQueuedEvent* queuedEvent = head.exchange(nullptr, std::memory_order_acquire);
+	if (!queuedEvent) return;
+
+	std::vector<std::unique_ptr<IQueuedEvent>> batch;
+	for (; queuedEvent; queuedEvent = queuedEvent->next)
+		batch.emplace_back(queuedEvent);
+
+	// the list is newest first, and threads interleave, so the order is rebuilt from where the events were queued
+	std::sort(batch.begin(), batch.end(), [](const std::unique_ptr<IQueuedEvent>& a, const std::unique_ptr<IQueuedEvent>& b) {
+		return a->source < b->source;
+	});
+
+	for (auto& queued : batch)
+		queued->dispatch(world);
+}
+
+} // namespace Saga
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <tuple>
+#include "../Entity/entity.h"
+
+namespace Saga {
+
+class GameWorld;
+
+/**
+ * @brief Where an event was queued from. Events from the same source keep the order in which they were queued,
+ * and sources are ordered by the position of their System in the stage's schedule, then by parallel loop and index within that System.
+ * None of this depends on which thread ran the System, so events reach their listeners in the same order on every run.
+ */
+struct EventSource {
+	std::uint32_t system = UINT32_MAX; //!< position of the System in its stage's schedule. Events queued outside of Systems come last.
+	std::uint32_t loop = 0; //!< the parallel loop of the System the event was queued from, counting from 1. 0 outside of parallel loops.
+	std::uint64_t index = 0; //!< the first index of the chunk of the parallel loop the event was queued from.
+	std::uint32_t counter = 0; //!< the number of events queued from the same source before this one.
+
+	bool operator<(const EventSource& other) const {
+		return std::tie(system, loop, index, counter) < std::tie(other.system, other.loop, other.index, other.counter);
+	}
+};
+
+/**
+ * @brief Generic event waiting in an EventQueue.
+ */
+class IQueuedEvent {
+public:
+	/**
+	 * @brief Destroy the IQueuedEvent object.
+	 */
+	virtual ~IQueuedEvent() = default;
+
+	/**
+	 * @brief Broadcast or deliver the event to the world's Systems.
+	 * 
+	 * @param world 
+	 */
+	virtual void dispatch(GameWorld& world) = 0;
+
+	int event; //!< the event, cast to an int.
+	bool broadcast; //!< whether the event is broadcast, rather than delivered to entity.
+	Entity entity; //!< the entity the event is delivered to, if it is not broadcast.
+	EventSource source; //!< where the event was queued from.
+	IQueuedEvent* next = nullptr; //!< the event queued just before this one.
+};
+
+/**
+ * @brief An event waiting in an EventQueue, along with the arguments it was raised with.
+ * 
+ * @tparam DataType the type of the arguments.
+ */
+template <typename... DataType>
+class QueuedEvent : public IQueuedEvent {
+public:
+	QueuedEvent(DataType... args) : args(std::move(args)...) {}
+
+	virtual void dispatch(GameWorld& world) override;
+private:
+	std::tuple<DataType...> args;
+};
+
+/**
+ * @brief Collects events raised from any thread, so that they reach their Systems later, on a single thread, in a stable order.
+ * Systems running in parallel cannot broadcast or deliver events directly, since the listeners could run concurrently on any thread.
+ * Queuing is lock free: every thread pushes onto the same list with a compare and swap.
+ * 
+ * Queued events are dispatched at the end of every stage, sorted by their EventSource. Events from one source thus arrive in the order they were raised,
+ * whatever their type or target: a Damage event raised before a Die event is received before it. The stage marks each System it runs as a Source, and parallelEach marks each chunk it processes,
+ * so the order does not depend on how threads interleave. Chunks are contiguous and processed in order, 
+ * so events queued from a parallel loop are ordered by index, however the loop was split into chunks.
+ * Parallel loops nested inside another parallel loop, and threads other than those running Systems, are only ordered by their own counter.
+ */
+class EventQueue {
+public:
+	/**
+	 * @brief Marks the events the calling thread queues, for as long as it lives, as coming from one System or one chunk of a parallel loop.
+	 * The thread's previous source is restored when it is destroyed.
+	 */
+	class Source {
+	public:
+		/**
+		 * @brief Events are queued by a System.
+		 * 
+		 * @param system the position of the System in its stage's schedule.
+		 */
+		explicit Source(std::uint32_t system);
+
+		/**
+		 * @brief Events are queued while processing a chunk of a parallel loop, see JobSystem::parallelForChunks().
+		 * 
+		 * @param loop the source returned by beginLoop(), on the thread that started the loop.
+		 * @param index the first index of the chunk.
+		 */
+		Source(const EventSource& loop, std::uint64_t index);
+
+		/**
+		 * @brief Restore the thread's previous source.
+		 */
+		~Source();
+
+		Source(const Source&) = delete;
+		Source& operator=(const Source&) = delete;
+	private:
+		EventSource previous;
+		std::uint32_t previousLoops;
+	};
+
+	/**
+	 * @brief Start a parallel loop from the calling thread's current source.
+	 * 
+	 * @return EventSource the source that each chunk of the loop derives its own from, see Source.
+	 */
+	static EventSource beginLoop();
+
+	/**
+	 * @brief Construct a new Event Queue for a world.
+	 * 
+	 * @param world the world whose Systems receive the events.
+	 */
+	EventQueue(GameWorld& world) : world(world) {}
+
+	/**
+	 * @brief Destroy the Event Queue, dropping events that were never dispatched.
+	 */
+	~EventQueue();
+
+	EventQueue(const EventQueue&) = delete;
+	EventQueue& operator=(const EventQueue&) = delete;
+
+	/**
+	 * @brief Queue an event to broadcast. Safe to call from any thread.
+	 * 
+	 * @tparam Event anything castable to an int.
+	 * @tparam DataType the types that the Systems listening to this event receive.
+	 * @param event 
+	 * @param args arguments for the Systems. They are copied into the queue.
+	 */
+	template <typename Event, typename... DataType>
+	void broadcast(Event event, DataType... args);
+
+	/**
+	 * @brief Queue an event to deliver to an entity. Safe to call from any thread.
+	 * 
+	 * @tparam Event anything castable to an int.
+	 * @tparam DataType the types that the Systems attached to the entity receive, after the entity itself.
+	 * @param event 
+	 * @param entity the entity to deliver the event to.
+	 * @param args arguments for the Systems. They are copied into the queue.
+	 */
+	template <typename Event, typename... DataType>
+	void deliver(Event event, Entity entity, DataType... args);
+
+	/**
+	 * @brief Dispatch every event queued so far, in a stable order. This must only be called from one thread at a time.
+	 * Events queued while dispatching are kept for the next dispatch.
+	 */
+	void dispatch();
+
+	/**
+	 * @return true if no events are waiting.
+	 * @return false otherwise.
+	 */
+	bool empty() const { return !head.load(std::memory_order_acquire); }
+private:
+	GameWorld& world;
+	std::atomic<IQueuedEvent*> head = nullptr; //!< the most recently queued event.
+
+	/**
+	 * @brief Push an event onto the queue.
+	 * 
+	 * @param queuedEvent an event with everything but its source filled in. The queue takes ownership.
+	 */
+	void push(IQueuedEvent* queuedEvent);
+};
+
+} // namespace Saga
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <tuple>
+#include "eventQueue.h"
+#include "gameworld.h"
+
+namespace Saga {
+
+template <typename... DataType>
+void QueuedEvent<DataType...>::dispatch(GameWorld& world) {
+	std::apply([&](DataType&... args) {
+		if (broadcast) world.broadcastEvent(event, args...);
+		else world.deliverEvent(event, entity, args...);
+	}, args);
+}
+
+template <typename Event, typename... DataType>
+void EventQueue::broadcast(Event event, DataType... args) {
+	IQueuedEvent* queuedEvent = new QueuedEvent<DataType...>(std::move(args)...);
+	queuedEvent->event = (int) event;
+	queuedEvent->broadcast = true;
+	queuedEvent->entity = Entity(0);
+	push(queuedEvent);
+}
+
+template <typename Event, typename... DataType>
+void EventQueue::deliver(Event event, Entity entity, DataType... args) {
+	IQueuedEvent* queuedEvent = new QueuedEvent<DataType...>(std::move(args)...);
+	queuedEvent->event = (int) event;
+	queuedEvent->broadcast = false;
+	queuedEvent->entity = entity;
+	push(queuedEvent);
+}
+
+} // namespace Saga
@@ -1,40 +1,181 @@
 #include "gameworld.h"
 #include "componentContainer.h"
 #include "../_Core/asserts.h"
+#include "../_Core/jobSystem.h"
 
 namespace Saga {
 
-GameWorld::GameWorld() {
-
+GameWorld::GameWorld() : commands(*this), events(*this), groupsByComponent(MAX_COMPONENTS) {
+	// slot 0 is reserved for the master entity, where the engine can place game information on.
+	entitySlots.push_back(makeEntity(0, 0));
+	entitySignatures.push_back(Signature(0));
 }
 
 GameWorld::~GameWorld() {
 
 }
 
-// we can do this since we start entity_cnt at 1
-Entity GameWorld::getMasterEntity() { return (Entity) 0; }
+// we can do this since slot 0 is never recycled
+Entity GameWorld::getMasterEntity() { return entitySlots[0]; }
 
 Entity GameWorld::createEntity() {
-	if (entity_cnt < 0)
-		SWARN("entity_cnt of a game world is %d < 0. This should not happen since entity_cnt starts at 0 and only increments. Check if an inherited object has changed this value.", entity_cnt);
-	entitySignatures[(Entity) entity_cnt] = Signature(0);
-	return (Entity) (entity_cnt++);
+	// slots reserved by the CommandBuffer come first, so that they are not handed out twice
+	commands.commitEntities();
+	if (!freeSlots.empty()) {
+		entity_type index = freeSlots.back();
+		freeSlots.pop_back();
+		// the generation has already been bumped when the slot was freed
+		return entitySlots[index];
+	}
+
+	entity_type index = entitySlots.size();
+	SASSERT_MESSAGE(index < ENTITY_INDEX_MASK, "Too many live entities in the world. Consider increasing ENTITY_INDEX_BITS in entity.h.");
+	entitySlots.push_back(makeEntity(index, 0));
+	entitySignatures.push_back(Signature(0));
+	return entitySlots[index];
+}
+
+std::vector<Entity> GameWorld::createEntities(std::size_t count) {
+	commands.commitEntities();
+	std::vector<Entity> entities;
+	entities.reserve(count);
+
+	// recycled slots first, newest freed first, like createEntity()
+	while (entities.size() < count && !freeSlots.empty()) {
+		entities.push_back(entitySlots[freeSlots.back()]);
+		freeSlots.pop_back();
+	}
+
+	std::size_t fresh = count - entities.size();
+	entity_type first = entitySlots.size();
+	SASSERT_MESSAGE(first + fresh <= ENTITY_INDEX_MASK, "Too many live entities in the world. Consider increasing ENTITY_INDEX_BITS in entity.h.");
+	entitySlots.reserve(first + fresh);
+	entitySignatures.resize(first + fresh);
+	for (entity_type index = first; index < first + fresh; index++) {
+		entitySlots.push_back(makeEntity(index, 0));
+		entities.push_back(entitySlots.back());
+	}
+	return entities;
+}
+
+bool GameWorld::isAlive(Entity entity) {
+	entity_type index = getEntityIndex(entity);
+	return index < entitySlots.size() && entitySlots[index] == entity;
+}
+
+JobSystem& GameWorld::getJobs() {
+	if (!jobs) jobs = std::make_shared<JobSystem>();
+	return *jobs;
 }
 
 void GameWorld::destroyEntity(Entity entity) {
-    entitiesToDestroy.insert(entity);
+	if (entity == getMasterEntity()) {
+		SWARN("Trying to destroy the master entity. This is not allowed.");
+		return;
+	}
+    entitiesToDestroy.push_back(entity);
+}
+
+void GameWorld::destroyEntities(std::span<const Entity> entities) {
+	for (Entity entity : entities) destroyEntity(entity);
 }
 
 void GameWorld::entityCleanup() {
+	// deferred changes may still touch entities that are about to be destroyed, so they go first.
+	// This also commits the slots the buffer reserved, before any slot is freed below
+	commands.playback();
+
+	// everything is driven by the entities' signatures, so only the groups and containers they belong to are touched
+	destroyedByComponent.resize(MAX_COMPONENTS);
+	std::size_t destroyedCnt = 0;
     for (Entity entity : entitiesToDestroy) {
-        for (auto & [key, container] : componentMap) 
-            container->onEntityDestroyed(entity);
-        for (auto & [key, group] : componentGroups)
-            group->removeEntity(entity);
-        systemManager.onEntityDestroyed(entity);
+		// stale handles, or entities destroyed twice
+		if (!isAlive(entity)) continue;
+		entitiesToDestroy[destroyedCnt++] = entity;
+
+		// groups go first, since packed groups need the components to still be in their containers.
+		// Only groups sharing a component with the entity can hold it. Each group is visited from its anchor component only.
+		Signature& signature = getSignature(entity);
+		for (int id = 0, left = signature.count(); left > 0; id++) {
+			if (!signature[id]) continue;
+			left--;
+			destroyedByComponent[id].push_back(entity);
+			for (auto &[groupSignature, anchor, group] : groupsByComponent[id]) {
+				if (anchor != id) continue;
+				groupChecks++;
+				if ((signature & groupSignature) == groupSignature)
+					group->removeEntity(entity);
+			}
+		}
+
+		// recycle the slot. Bumping the generation invalidates any handle still pointing to this entity, and skips later duplicates.
+		entity_type index = getEntityIndex(entity);
+		entitySignatures[index].reset();
+		entitySlots[index] = makeEntity(index, getEntityGeneration(entity) + 1);
+		freeSlots.push_back(index);
     }
+
+	// each container removes all of its destroyed entities in one go. Tags have no container, or an empty one.
+	for (int id = 0; id < MAX_COMPONENTS; id++) {
+		std::vector<Entity>& destroyed = destroyedByComponent[id];
+		if (destroyed.empty()) continue;
+		auto it = componentMap.find(id);
+		if (it != componentMap.end()) it->second->onEntitiesDestroyed(destroyed);
+		destroyed.clear();
+	}
+	entitiesToDestroy.resize(destroyedCnt);
+	systemManager.onEntitiesDestroyed(entitiesToDestroy);
     entitiesToDestroy.clear();
+
+	// groups that queries asked for. Registering them backfills them from the entities that are left.
+	std::vector<std::function<void(GameWorld&)>> groups;
+	{
+		std::lock_guard<std::mutex> lock(queryMutex);
+		groups.swap(pendingGroups);
+	}
+	for (auto& registerGroup : groups)
+		registerGroup(*this);
+}
+
+void GameWorld::addToSignature(Entity entity, int componentId) {
+	Signature& signature = getSignature(entity);
+	signature[componentId] = true;
+
+	// add entity to the relevant groups. Only groups containing this component can be affected, and the entity was not in any of them before this.
+	for (auto &[groupSignature, anchor, group] : groupsByComponent[componentId]) {
+		groupChecks++;
+		if ((signature & groupSignature) == groupSignature) 
+			group->addEntity(*this, entity);
+	}
+}
+
+void GameWorld::addToSignatures(std::span<const Entity> entities, int componentId) {
+	for (Entity entity : entities)
+		getSignature(entity)[componentId] = true;
+
+	// each group gets every new member in one call
+	std::vector<Entity> members;
+	for (auto &[groupSignature, anchor, group] : groupsByComponent[componentId]) {
+		groupChecks += entities.size();
+		members.clear();
+		for (Entity entity : entities)
+			if ((getSignature(entity) & groupSignature) == groupSignature)
+				members.push_back(entity);
+		if (!members.empty()) group->addEntities(*this, members);
+	}
+}
+
+void GameWorld::endFrame() {
+	lastFrameGroupChecks = groupChecks;
+	groupChecks = 0;
+
+	tick++;
+	for (auto & [key, container] : componentMap)
+		container->setTick(tick);
+}
+
+std::shared_ptr<GameWorld> WorldRef::shared() const {
+	return world->shared_from_this();
 }
 
 }
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <span>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -9,12 +13,17 @@
 #include "../Systems/system.h"
 #include "../Entity/entity.h"
 #include "signature.h"
+#include "commandBuffer.h"
+#include "eventQueue.h"
+#include "query.h"
 #include "componentReference.h"
 
 namespace Saga {
 
 class IComponentContainer;
 
+class JobSystem;
+
 template<typename Component>
 class ComponentContainer;
 
@@ -23,6 +32,18 @@ class IComponentGroup;
 template<typename... Component>
 class ComponentGroup;
 
+/**
+ * @brief How a ComponentGroup stores the entities it contains.
+ */
+enum class GroupStorage {
+	Referenced, //!< keep a list of references to each entity's components. Any number of groups can share the same component types.
+	/**
+	 * Own the containers of the group's components, keeping the group's members packed at the front of each container in the same order.
+	 * Iterating the group then reads every component array linearly. Each component type can be owned by at most one Packed group.
+	 */
+	Packed
+};
+
 /**
  * @brief Maintains a game world, where Entity, Component, Systems, and MetaSystems can be added, and events such as Startup, Update, FixedUpdate, and Draw can be invoked.
  */
@@ -38,12 +59,31 @@ public:
 	virtual ~GameWorld();
 
 	/**
-	 * @brief Create a Entity object.
+	 * @brief Create a Entity object. Slots of destroyed entities are recycled, with their generation bumped.
+	 * This grows the world, so Systems that run in parallel with others create entities through getCommands() instead.
 	 * 
 	 * @return Entity 
 	 */
 	Entity createEntity();
 
+	/**
+	 * @brief Create several Entity objects at once. Recycled slots are used first, and the rest is reserved in one go.
+	 * 
+	 * @param count the number of entities to create.
+	 * @return std::vector<Entity> the new entities.
+	 */
+	std::vector<Entity> createEntities(std::size_t count);
+
+	/**
+	 * @brief Determine if an entity handle still refers to a live entity.
+	 * Handles to destroyed entities stay invalid even after their slot gets recycled, as the generation no longer matches.
+	 * 
+	 * @param entity 
+	 * @return true if the entity has been created and not yet cleaned up.
+	 * @return false otherwise.
+	 */
+	bool isAlive(Entity entity);
+
     /**
      * @brief Get the master entity. Use this entity only for placing global data, such as 
      * baked navmeshes, lightning information, etc. Do not use it as a gameobject.
@@ -60,6 +100,13 @@ public:
 	 */
 	void destroyEntity(Entity entity);
 
+	/**
+	 * @brief Destroy several Entity objects. Like destroyEntity(), they are cleaned up once all systems are done.
+	 * 
+	 * @param entities 
+	 */
+	void destroyEntities(std::span<const Entity> entities);
+
 	/**
 	 * @brief Emplace a component to an Entity. This constructs the component instead of adding them.
 	 * 
@@ -73,6 +120,19 @@ public:
     template<typename Component, typename ...Args>
 	ComponentReference<Component> emplace(const Entity entity, Args &&...args);
 
+	/**
+	 * @brief Emplace a component onto each of a list of entities. The container reserves room for all of them once, 
+	 * and every group containing the component is updated once for the whole list.
+	 * This is the way to spawn many entities at once, such as when loading a level. 
+	 * 
+	 * @tparam Component The type of the Component.
+	 * @tparam Args The type of the parameters used to construct the Component.
+	 * @param entities the entities. None of them may have the component already.
+	 * @param args the arguments used to construct each of the Components.
+	 */
+    template<typename Component, typename ...Args>
+	void emplaceBulk(std::span<const Entity> entities, const Args &...args);
+
 	/**
 	 * @brief Get a reference to a Component on the specified entity.
 	 * 
@@ -83,14 +143,14 @@ public:
     template<typename Component>
 	ComponentReference<Component> getComponent(const Entity entity);
 
-	// slow af so don't use
 	/**
 	 * @brief Get the Entity from a pointer to a component.
 	 * 
 	 * @tparam Component the type of component you use.
 	 * @param component 
 	 * @return Entity the entity, or -1 if none exists.
-	 * @warning this runs in O(n), where n is the number of components of that type.
+	 * @note this runs in O(p), where p is the number of pages holding components of that type, 
+	 * as the page holding the pointer has to be found first. See ComponentContainer::getEntity.
 	 */
     template<typename Component>
 	Entity getEntity(Component* component);
@@ -115,31 +175,156 @@ public:
     template<typename Component>
 	void removeComponent(const Entity entity);
 
+	/**
+	 * @brief Mark an entity's component as changed during the current tick, so that queries with a Changed filter pick it up.
+	 * Mutable access through a ComponentReference or a query does this already. Changes made through pointers from viewAll() or viewGroup() 
+	 * are not tracked, so call this after them.
+	 * 
+	 * @tparam Component type of the component.
+	 * @param entity 
+	 */
+	template<typename Component>
+	void markChanged(const Entity entity);
+
+	/**
+	 * @brief Get the current tick of the world. The tick starts at 1 and increases by 1 at the end of every frame. 
+	 * Components are stamped with it when they are added or changed.
+	 * 
+	 * @return std::uint32_t 
+	 */
+	std::uint32_t getTick() const { return tick; }
+
 	/**
 	 * @tparam Component type of component to look for.
 	 * @return std::shared_ptr<ComponentContainer<Component>> a container of components that can be iterated through. 
+	 * Tags (see isTag) are not stored, so their container is always empty. Use query() or a group to find the entities that have one.
 	 */
 	template<typename Component>
 	std::shared_ptr<ComponentContainer<Component>> viewAll();
 
 	/**
-	 * @brief Register a ComponentGroup.
+	 * @brief Register a ComponentGroup. Entities that already have all the group's components are added to it.
 	 * 
-	 * @tparam Component a list of components entities in the group must have, in @em alphabetical order. 
+	 * @tparam Component a list of components entities in the group must have, in any order. Every order registers the same group.
+	 * @param storage how the group stores its entities. If a Packed group is requested but one of its components is 
+	 * 	already owned by another Packed group, this falls back to a Referenced group.
 	 * @return std::shared_ptr<ComponentGroup<Component...>> a shared_ptr to that group.
 	 */
 	template<typename... Component>
-	std::shared_ptr<ComponentGroup<Component...>> registerGroup();
+	std::shared_ptr<ComponentGroup<Component...>> registerGroup(GroupStorage storage = GroupStorage::Referenced);
 
 	/**
-	 * @brief Compute the view of a Group. It is mandatory that this group is registered before this operation, and before any components were added to the world.
+	 * @brief Compute the view of a Group. It is mandatory that this group is registered before this operation.
+	 * After the first call, this is a lookup into an array of the world's groups. 
+	 * Asking for the components in another order than they were registered in creates a view the first time, under a lock, so Systems running in parallel can do so.
 	 * 
-	 * @tparam Component the types of components the group has, in @em alphabetical order.
+	 * @tparam Component the types of components the group has, in any order. Entries yield the components in this order.
 	 * @return std::shared_ptr<ComponentGroup<Component...>> a group that can be iterated through, containing all the entities with the specified group.
 	 */
 	template<typename... Component>
 	std::shared_ptr<ComponentGroup<Component...>> viewGroup();
 
+	/**
+	 * @brief Query the entities that pass a list of filters. Unlike viewGroup(), this needs no group to be registered.
+	 * If one is registered for the components in With, it drives the query. A query that runs often without one registers it 
+	 * at the next entityCleanup. For example, 
+	 * @code
+	 * for (auto &[entity, emitter, transform, rigidBody] : world->query<With<AudioEmitter, Transform>, Optional<RigidBody>>())
+	 * @endcode
+	 * 
+	 * @tparam Filter any number of With, Without, Optional, Changed and Added, in any order. At least one component must be in a With.
+	 * @param since the tick that Changed and Added filters compare against. By default, the start of the previous frame,
+	 * 	so a System that runs once per frame sees every change at least once.
+	 * @return QueryOf<Filter...> a query that can be iterated through, yielding the Entity, a pointer to each component in With, 
+	 * 	then a pointer to each component in Optional, which is null if the entity does not have it.
+	 */
+	template<typename... Filter>
+	QueryOf<Filter...> query(std::uint32_t since) { return QueryOf<Filter...>(*this, since); }
+	template<typename... Filter>
+	QueryOf<Filter...> query() { return QueryOf<Filter...>(*this, tick - 1); }
+
+	/**
+	 * @brief Get the world's resource of a type, creating it the first time it is asked for. Resources hold data that is global to a world, 
+	 * such as caches shared between Systems. They are not components: no entity owns them, and queries, groups and viewAll() never see them.
+	 * A resource lives until removeResource() is called, or until the world is destroyed.
+	 * Creating a resource is a structural change, so it should happen during setup, or from a System that runs alone.
+	 * 
+	 * @tparam Resource the type of the resource. A world has at most one resource of each type.
+	 * @tparam Args 
+	 * @param args used to construct the resource if it does not exist yet. Ignored otherwise.
+	 * @return Resource& the resource. The reference stays valid until the resource is removed.
+	 */
+	template<typename Resource, typename... Args>
+	Resource& resource(Args &&...args);
+
+	/**
+	 * @brief Construct the world's resource of a type, replacing the one that exists.
+	 * 
+	 * @tparam Resource the type of the resource.
+	 * @tparam Args 
+	 * @param args used to construct the resource.
+	 * @return Resource& the new resource.
+	 */
+	template<typename Resource, typename... Args>
+	Resource& emplaceResource(Args &&...args);
+
+	/**
+	 * @tparam Resource the type of the resource.
+	 * @return Resource* the world's resource of this type, or nullptr if it does not have one.
+	 */
+	template<typename Resource>
+	Resource* findResource();
+
+	/**
+	 * @brief Destroy the world's resource of a type, if it has one. References to it are no longer valid.
+	 * 
+	 * @tparam Resource the type of the resource.
+	 */
+	template<typename Resource>
+	void removeResource();
+
+	/**
+	 * @brief Get the CommandBuffer of this world. Structural changes recorded there are applied during the next entityCleanup, 
+	 * which makes it the safe way to spawn or change entities while a System is iterating through components.
+	 * 
+	 * @return CommandBuffer& 
+	 */
+	CommandBuffer& getCommands() { return commands; }
+
+	/**
+	 * @brief Get the EventQueue of this world. Events queued there are broadcast or delivered at the end of the current stage, 
+	 * which makes it the safe way to raise events from Systems running in parallel.
+	 * 
+	 * @return EventQueue& 
+	 */
+	EventQueue& getEvents() { return events; }
+
+	/**
+	 * @brief Get the JobSystem this world runs parallel work on. Worlds created by an App share the App's JobSystem. 
+	 * A world used on its own creates one the first time it is asked for.
+	 * 
+	 * @return JobSystem& 
+	 */
+	JobSystem& getJobs();
+
+	/**
+	 * @brief Set the JobSystem this world runs parallel work on.
+	 * 
+	 * @param jobs 
+	 */
+	void setJobs(std::shared_ptr<JobSystem> jobs) { this->jobs = jobs; }
+
+	/**
+	 * @brief Call a function on every entry of a registered group, in parallel across the world's JobSystem. 
+	 * No component of the group's types can be added or removed until this returns, so record structural changes in the CommandBuffer instead.
+	 * 
+	 * @tparam Component the types of components the group has, in any order.
+	 * @tparam Function callable with an Entity and a pointer to each of the components, like the entries of viewGroup().
+	 * @param function 
+	 */
+	template<typename... Component, typename Function>
+	void parallelEach(Function&& function);
+
 	/**
 	 * @brief Get the SystemManager object.
 	 * 
@@ -158,6 +343,7 @@ public:
 
 	/**
 	 * @brief Broadcast an event to the world, so that Systems that listen to the event can be triggered.
+	 * Listeners run immediately, on the calling thread. From Systems running in parallel, queue the event in getEvents() instead.
 	 * 
 	 * @tparam Event can be anything castable to an int.
 	 * @tparam DataType the type of parameters used to broadcast the event, and also the types that the Systems will receive.
@@ -169,6 +355,7 @@ public:
 
 	/**
 	 * @brief Deliver an event to a specific object. Only System that registers to that specific object will be called.
+	 * Listeners run immediately, on the calling thread. From Systems running in parallel, queue the event in getEvents() instead.
 	 * 
 	 * @tparam Event anything castable to an int.
 	 * @tparam DataType the type of parameters used in the delivery.
@@ -179,32 +366,121 @@ public:
 	template<typename Event, typename... DataType>
 	void deliverEvent(Event event, Entity entity, DataType... args);
 
+	/**
+	 * @brief Get the number of group checks performed during the last frame. A group check happens whenever adding or removing a component,
+	 * or destroying an entity, has to test whether a group is affected. Only groups that contain the component involved are checked.
+	 * 
+	 * @return std::size_t 
+	 */
+	std::size_t getGroupChecks() const { return lastFrameGroupChecks; }
+
 protected:
-	entity_type entity_cnt = 1; //!< number of entities in the world. Useful for assigning new entities. We start at 1, because we assume an entity 0 where the engine can place game information on.
 
 	/**
 	 * @brief Create a signature from a list of component types.
 	 * 
-	 * @tparam Component a list of component types, in @em alphabetical order.
+	 * @tparam Component a list of component types, in any order.
 	 * @return Signature the correponding signature.
 	 */
 	template<typename... Component>
 	Signature createSignature();
 
 	InvokableSystemManager systemManager; //!< where all the systems are stored and can potentially be invoked.
+	CommandBuffer commands; //!< structural changes deferred to the next entityCleanup.
+	EventQueue events; //!< events deferred to the end of the current stage.
+	std::shared_ptr<JobSystem> jobs; //!< where parallel work runs. Can be null until getJobs() is called.
 
     /**
      * @brief Destroy / cleanup any entity. This should happen after every frame, so that all entities that
      * is signaled to be destroyed will be cleaned up. This ensures entities are not deleted while a
-     * system is still processing it.
+     * system is still processing it. Changes recorded in the CommandBuffer are played back first.
      */
     void entityCleanup();
+
+	/**
+	 * @brief Mark the end of a frame, so that per-frame statistics such as getGroupChecks() start counting again.
+	 */
+	void endFrame();
 private:
+	template <typename Required, typename Excluded, typename Optionals, typename Changes, typename Additions> friend class Query;
+	friend class CommandBuffer;
+
+	/**
+	 * @brief A registered group, as seen from one of its components.
+	 */
+	struct GroupEntry {
+		Signature signature; //!< the signature of the group.
+		int anchor; //!< id of the group's first component. Used to visit each group once when walking all of an entity's components.
+		std::shared_ptr<IComponentGroup> group;
+	};
+
 	TypeMap<std::shared_ptr<IComponentContainer>> componentMap; //!< map between Component and their containers
-	std::unordered_map<Entity, Signature> entitySignatures; //!< map between entities and their signature
-	std::unordered_map<Signature, std::shared_ptr<IComponentGroup>> componentGroups; //!< map between signature and ComponentGroup
-    std::unordered_set<Entity> entitiesToDestroy;
+	std::vector<Entity> entitySlots; //!< the live (or next to be issued) handle for each slot index. Slot 0 is the master entity.
+	std::vector<entity_type> freeSlots; //!< indices of slots whose entity has been destroyed, ready to be recycled.
+	std::vector<Signature> entitySignatures; //!< signature of each entity, indexed by slot index.
+	std::vector<std::shared_ptr<IComponentGroup>> groupSlots; //!< registered groups, indexed by ComponentGroup::getSlot(). Empty slots are null. Only changes when a group is registered.
+	std::vector<std::shared_ptr<IComponentGroup>> groupViews; //!< views of registered groups in other type orders, indexed by ComponentGroup::getSlot(). Created on first use.
+	std::mutex groupViewMutex; //!< guards groupViews, as views can be asked for from Systems in parallel.
+	std::vector<std::vector<GroupEntry>> groupsByComponent; //!< for each component id, the groups that contain that component.
+	std::size_t groupChecks = 0; //!< group checks performed so far this frame.
+	std::size_t lastFrameGroupChecks = 0; //!< group checks performed during the last frame.
+	std::uint32_t tick = 1; //!< the current tick. See getTick().
+	Signature packedComponents; //!< components whose containers are owned by a Packed group.
+	std::mutex queryMutex; //!< guards queryUses and pendingGroups, as queries can run from Systems in parallel.
+	std::unordered_map<int, int> queryUses; //!< for each group slot, number of queries that ran without that group registered.
+	std::vector<std::function<void(GameWorld&)>> pendingGroups; //!< groups requested by queries, registered during the next entityCleanup.
+	std::vector<Entity> entitiesToDestroy; //!< entities to destroy during the next entityCleanup. May hold duplicates and stale handles.
+	std::vector<std::vector<Entity>> destroyedByComponent; //!< scratch space for entityCleanup: for each component id, the destroyed entities that had it.
+	std::vector<std::shared_ptr<void>> resources; //!< resources of the world, indexed by getResourceId(). Empty slots are null.
+
+	/**
+	 * @brief Get the signature of a live entity.
+	 * 
+	 * @param entity 
+	 * @return Signature& the signature, indexed by the entity's slot.
+	 */
+	inline Signature& getSignature(Entity entity) { return entitySignatures[getEntityIndex(entity)]; }
 
+	/**
+	 * @brief Record that an entity gained a component, and add it to the groups it now belongs to.
+	 * 
+	 * @param entity 
+	 * @param componentId the id of the component, from getTypeId().
+	 */
+	void addToSignature(Entity entity, int componentId);
+
+	/**
+	 * @brief Record that several entities gained a component, and add them to the groups they now belong to, once per group.
+	 * 
+	 * @param entities 
+	 * @param componentId the id of the component, from getTypeId().
+	 */
+	void addToSignatures(std::span<const Entity> entities, int componentId);
+
+	/**
+	 * @brief Find a group that is not registered in this exact order. Views of a registered group are looked up, or created, here.
+	 * 
+	 * @tparam Component the types of components the group has, in any order.
+	 * @return std::shared_ptr<ComponentGroup<Component...>> the group, or an empty group if it was never registered.
+	 */
+	template<typename... Component>
+	std::shared_ptr<ComponentGroup<Component...>> resolveGroup();
+
+	/**
+	 * @brief Get the slot of a type of resource. Resource types are numbered separately from components, so the slots stay dense.
+	 * 
+	 * @tparam Resource 
+	 * @return int 
+	 */
+	template<typename Resource>
+	static int getResourceId() { return TypeMap<std::shared_ptr<void>>::getTypeId<Resource>(); }
+
+	/**
+	 * @tparam Component a list of component types.
+	 * @return std::string the names of the types, for logging.
+	 */
+	template<typename... Component>
+	static std::string describeComponents();
 
 };
 
@@ -4,49 +4,84 @@
 #include "componentContainer.h"
 #include "componentGroup.h"
 #include "componentReference.h"
+#include "commandBuffer.inl"
+#include "eventQueue.inl"
+#include "query.inl"
+#include "../Systems/systemAccess.inl"
 #include "../_Core/asserts.h"
+#include <limits>
 
 namespace Saga {
 
 template <typename Component, typename... Args>
 ComponentReference<Component> GameWorld::emplace(const Entity entity, Args &&...args) {
-	// guarantee that the component container is not a null reference
-	if (!componentMap.hasKey<Component>()) {
-		SASSERT_MESSAGE(componentMap.size() < MAX_COMPONENTS, "Too many component types have been added to the World. Consider increasing MAX_COMPONENTS in signature.h.");
-		componentMap.put<Component>(std::make_shared<ComponentContainer<Component>>());
-	}
+	SASSERT_DEBUG_MESSAGE(isAlive(entity), "Trying to emplace a component onto an entity that is not alive.");
 
-	auto it = componentMap.find<Component>();
-	// at this point, we know that this container contains component
-	Component* component = std::dynamic_pointer_cast<ComponentContainer<Component>>(it->second)->emplace(entity, args...);
+	// tags only live in the signature
+	if constexpr (isTag<Component>) {
+		SASSERT_MESSAGE(getTypeId<Component>() < MAX_COMPONENTS, "Too many component types have been added to the World. Consider increasing MAX_COMPONENTS in signature.h.");
+		SASSERT_DEBUG_MESSAGE(!getSignature(entity)[getTypeId<Component>()], "Entity already has a component of the same type attached. You cannot have multiple of the same component type attached to the same entity.");
+		addToSignature(entity, getTypeId<Component>());
+		return ComponentReference<Component>(this, entity);
+	} else {
+		// guarantee that the component container is not a null reference
+		if (!componentMap.hasKey<Component>()) {
+			SASSERT_MESSAGE(componentMap.size() < MAX_COMPONENTS, "Too many component types have been added to the World. Consider increasing MAX_COMPONENTS in signature.h.");
+			componentMap.put<Component>(std::make_shared<ComponentContainer<Component>>());
+			componentMap.find<Component>()->second->setTick(tick);
+		}
 
-	// first obtain a new signature for the entity
-	Signature& signature = entitySignatures[entity];
-	int componentId = getTypeId<Component>();
-	signature[componentId] = true;
+		auto it = componentMap.find<Component>();
+		// at this point, we know that this container contains component
+		auto container = std::static_pointer_cast<ComponentContainer<Component>>(it->second);
+		container->emplace(entity, std::forward<Args>(args)...);
 
-	// add entity to the relevant groups. Only consider groups that the entity would not have been in before this.
-	for (auto &[groupSignature, group] : componentGroups) 
-		if ((signature & groupSignature) == groupSignature && groupSignature[componentId]) 
-			group->addEntity(shared_from_this(), entity);
+		addToSignature(entity, getTypeId<Component>());
+		return ComponentReference<Component>(std::move(container), entity);
+	}
+}
+
+template <typename Component, typename... Args>
+void GameWorld::emplaceBulk(std::span<const Entity> entities, const Args &...args) {
+	if (entities.empty()) return;
+	for (Entity entity : entities) {
+		SASSERT_DEBUG_MESSAGE(isAlive(entity), "Trying to emplace a component onto an entity that is not alive.");
+		SASSERT_DEBUG_MESSAGE(!getSignature(entity)[getTypeId<Component>()], "Entity already has a component of the same type attached. You cannot have multiple of the same component type attached to the same entity.");
+	}
+
+	// tags only live in the signature
+	if constexpr (isTag<Component>) {
+		SASSERT_MESSAGE(getTypeId<Component>() < MAX_COMPONENTS, "Too many component types have been added to the World. Consider increasing MAX_COMPONENTS in signature.h.");
+	} else {
+		if (!componentMap.hasKey<Component>()) {
+			SASSERT_MESSAGE(componentMap.size() < MAX_COMPONENTS, "Too many component types have been added to the World. Consider increasing MAX_COMPONENTS in signature.h.");
+			componentMap.put<Component>(std::make_shared<ComponentContainer<Component>>());
+			componentMap.find<Component>()->second->setTick(tick);
+		}
+		viewAll<Component>()->emplaceBulk(entities, args...);
+	}
 
-	return ComponentReference<Component>(viewAll<Component>(), entity);
+	addToSignatures(entities, getTypeId<Component>());
 }
 
 template <typename Component>
 std::shared_ptr<ComponentContainer<Component>> GameWorld::viewAll() {
-	if (!componentMap.hasKey<Component>())
+	if (!componentMap.hasKey<Component>()) {
 		componentMap.put<Component>(std::make_shared<ComponentContainer<Component>>());
+		componentMap.find<Component>()->second->setTick(tick);
+	}
 	return std::static_pointer_cast<ComponentContainer<Component>>(componentMap.find<Component>()->second);
 }
 
 template<typename Component>
 ComponentReference<Component> GameWorld::getComponent(const Entity entity) {
-    return ComponentReference<Component>(viewAll<Component>(), entity);
+	if constexpr (isTag<Component>) return ComponentReference<Component>(this, entity);
+    else return ComponentReference<Component>(viewAll<Component>(), entity);
 }
 
 template<typename Component>
 bool GameWorld::hasComponent(const Entity entity) {
+	if constexpr (isTag<Component>) return isAlive(entity) && getSignature(entity)[getTypeId<Component>()];
     return viewAll<Component>()->hasComponent(entity);
 }
 
@@ -57,75 +92,187 @@ Entity GameWorld::getEntity(Component* component) {
 
 template<typename Component>
 void GameWorld::removeComponent(const Entity entity) {
-	Signature& signature = entitySignatures[entity];
+	if (!isAlive(entity)) return;
+	Signature& signature = getSignature(entity);
 
 	int componentId = getTypeId<Component>();
 
-	// find groups that this component no longer belong to a group
-    for (auto &[groupSignature, group] : componentGroups)
-        if (((signature & groupSignature) == groupSignature) && groupSignature[componentId])
+	// find groups that this entity no longer belongs to. Only groups containing this component can be affected.
+	for (auto &[groupSignature, anchor, group] : groupsByComponent[componentId]) {
+		groupChecks++;
+		if ((signature & groupSignature) == groupSignature)
 			group->removeEntity(entity);
+	}
 
 	// update signature of the entity
 	signature[componentId] = false;
-    return viewAll<Component>()->removeComponent(entity);
+	if constexpr (!isTag<Component>) viewAll<Component>()->removeComponent(entity);
+}
+
+template<typename Component>
+void GameWorld::markChanged(const Entity entity) {
+	// tags carry no data, so there is nothing to change
+	if constexpr (isTag<Component>) return;
+	auto container = viewAll<Component>();
+	std::uint32_t index = container->getIndex(entity);
+	if (index != SparseSet::NULL_INDEX) container->markChanged(index);
+}
+
+template<typename Resource, typename... Args>
+Resource& GameWorld::resource(Args &&...args) {
+	if (Resource* existing = findResource<Resource>()) return *existing;
+	return emplaceResource<Resource>(std::forward<Args>(args)...);
+}
+
+template<typename Resource, typename... Args>
+Resource& GameWorld::emplaceResource(Args &&...args) {
+	std::size_t id = getResourceId<Resource>();
+	if (id >= resources.size()) resources.resize(id + 1);
+	auto resource = std::make_shared<Resource>(std::forward<Args>(args)...);
+	resources[id] = resource;
+	return *resource;
+}
+
+template<typename Resource>
+Resource* GameWorld::findResource() {
+	std::size_t id = getResourceId<Resource>();
+	if (id >= resources.size()) return nullptr;
+	return static_cast<Resource*>(resources[id].get());
+}
+
+template<typename Resource>
+void GameWorld::removeResource() {
+	std::size_t id = getResourceId<Resource>();
+	if (id < resources.size()) resources[id].reset();
+}
+
+template <typename Component> requires isTag<Component>
+Component* ComponentReference<Component>::get() const {
+	return world && world->hasComponent<Component>(entity) ? &tagInstance<Component> : nullptr;
 }
 
 template<typename... Component>
-std::shared_ptr<ComponentGroup<Component...>> GameWorld::registerGroup() {
-	Signature groupSignature = createSignature<Component...>();
-	if (!componentGroups.count(groupSignature))
-    	componentGroups[groupSignature] = std::make_shared<ComponentGroup<Component...>>();
-	else {
-        std::string namesOfComponents;
+std::shared_ptr<ComponentGroup<Component...>> GameWorld::registerGroup(GroupStorage storage) {
+	using Group = ComponentGroup<Component...>;
+	if constexpr (!Group::isCanonical) {
+		// the entities are stored by the group listing these components in canonical order. This one is a view of it.
+		[&]<typename... Sorted>(ComponentGroup<Sorted...>*) { registerGroup<Sorted...>(storage); }(static_cast<CanonicalGroup<Component...>*>(nullptr));
+		return viewGroup<Component...>();
+	}
+
+	std::size_t slot = Group::getSlot();
+	if (slot >= groupSlots.size()) groupSlots.resize(slot + 1);
+	if (!groupSlots[slot]) {
+		Signature groupSignature = createSignature<Component...>();
+		// tags have nothing to pack, so a packed group only owns the containers of its other components
+		Signature ownedSignature;
+		([&] { if constexpr (!isTag<Component>) ownedSignature.set(getTypeId<Component>()); }(), ...);
+		if (storage == GroupStorage::Packed && ownedSignature.none()) {
+			SWARN("A group made only of tags cannot be packed. Falling back to a referenced group.");
+			storage = GroupStorage::Referenced;
+		}
+		if (storage == GroupStorage::Packed && (packedComponents & ownedSignature).any()) {
+			SWARN("A component in this group is already owned by another packed group. Falling back to a referenced group.");
+			storage = GroupStorage::Referenced;
+		}
+		if (storage == GroupStorage::Packed) packedComponents |= ownedSignature;
+
+		auto group = std::make_shared<Group>(storage, viewAll<Component>()...);
+		groupSlots[slot] = group;
+		int anchor = getTypeId<std::tuple_element_t<0, std::tuple<Component...>>>();
+		for (int id : {getTypeId<Component>()...})
+			groupsByComponent[id].push_back({groupSignature, anchor, group});
+
+		// pick up entities that already have all the components. Any container will do, so we walk the smallest one.
+		// Tags have no container to walk, so a group made only of tags walks every entity.
+		const std::vector<Entity>* candidates = &entitySlots;
+		std::size_t smallest = std::numeric_limits<std::size_t>::max();
 		([&] {
-            namesOfComponents += typeid(Component).name();
-            namesOfComponents += ", ";
+			if constexpr (!isTag<Component>) {
+				auto& container = *viewAll<Component>();
+				if (container.size() >= smallest) return;
+				smallest = container.size();
+				candidates = &container.getEntities().entities();
+			}
 		}(), ...);
-		if (namesOfComponents.size()) {
-			namesOfComponents.pop_back();
-			namesOfComponents.back() = '.';
-		}
-        SWARN("A group with the same signature already exists. Group consists of: %s", namesOfComponents.c_str());
+		std::vector<Entity> members;
+		for (Entity entity : *candidates)
+			if (isAlive(entity) && (getSignature(entity) & groupSignature) == groupSignature)
+				members.push_back(entity);
+		for (Entity entity : members)
+			group->addEntity(*this, entity);
+	} else {
+		SWARN("A group with the same signature already exists. Group consists of: %s", describeComponents<Component...>().c_str());
 	}
-    return std::dynamic_pointer_cast<ComponentGroup<Component...>>(componentGroups[groupSignature]);
+	return std::static_pointer_cast<Group>(groupSlots[slot]);
 }
 
 template<typename... Component>
 std::shared_ptr<ComponentGroup<Component...>> GameWorld::viewGroup() {
-	Signature groupSignature = createSignature<Component...>(); 
-	if (!componentGroups.count(groupSignature)) {
-        std::string namesOfComponents;
-		([&] {
-            namesOfComponents += typeid(Component).name();
-            namesOfComponents += ", ";
-		}(), ...);
-		if (namesOfComponents.size()) {
-			namesOfComponents.pop_back();
-			namesOfComponents.back() = '.';
-		}
-		SERROR("Component group consisting of %s does not exist! Resolved by returning an empty component group.", namesOfComponents.c_str());
-		return std::make_shared<ComponentGroup<Component...>>();
+	using Group = ComponentGroup<Component...>;
+	// registered groups only change when no System is running, so they can be read without a lock
+	if constexpr (Group::isCanonical) {
+		std::size_t slot = Group::getSlot();
+		if (slot < groupSlots.size() && groupSlots[slot])
+			return std::static_pointer_cast<Group>(groupSlots[slot]);
 	}
-	return std::dynamic_pointer_cast<ComponentGroup<Component...>>(componentGroups[groupSignature]);
+	return resolveGroup<Component...>();
+}
+
+template<typename... Component>
+std::shared_ptr<ComponentGroup<Component...>> GameWorld::resolveGroup() {
+	using Group = ComponentGroup<Component...>;
+	std::size_t canonicalSlot = CanonicalGroup<Component...>::getSlot();
+	if (canonicalSlot >= groupSlots.size() || !groupSlots[canonicalSlot]) {
+		SERROR("Component group consisting of %s does not exist! Resolved by returning an empty component group.", describeComponents<Component...>().c_str());
+		return std::make_shared<Group>();
+	}
+
+	// views are created the first time they are asked for, possibly by several Systems at once
+	if constexpr (!Group::isCanonical) {
+		std::size_t slot = Group::getSlot();
+		std::lock_guard<std::mutex> lock(groupViewMutex);
+		if (slot >= groupViews.size()) groupViews.resize(slot + 1);
+		if (!groupViews[slot]) groupViews[slot] = std::make_shared<Group>(std::static_pointer_cast<CanonicalGroup<Component...>>(groupSlots[canonicalSlot]));
+		return std::static_pointer_cast<Group>(groupViews[slot]);
+	}
+	return std::static_pointer_cast<Group>(groupSlots[canonicalSlot]);
+}
+
+template<typename... Component>
+std::string GameWorld::describeComponents() {
+	std::string namesOfComponents;
+	([&] {
+		namesOfComponents += typeid(Component).name();
+		namesOfComponents += ", ";
+	}(), ...);
+	if (namesOfComponents.size()) {
+		namesOfComponents.pop_back();
+		namesOfComponents.back() = '.';
+	}
+	return namesOfComponents;
+}
+
+template<typename... Component, typename Function>
+void GameWorld::parallelEach(Function&& function) {
+	viewGroup<Component...>()->parallelEach(getJobs(), function);
 }
 
 template<typename... Component>
 Signature GameWorld::createSignature() {
 	Signature signature(0);
-	for (int id : {getTypeId<Component>()...})
-		signature[id] = true;
+	(signature.set(getTypeId<Component>()), ...);
     return signature;
 }
 
 template<typename Event, typename... DataType>
 void GameWorld::broadcastEvent(Event event, DataType... args) {
-	systemManager.broadcastEvent(event,shared_from_this(), args...);
+	systemManager.broadcastEvent(event, WorldRef(*this), args...);
 }
 
 template<typename Event, typename... DataType>
 void GameWorld::deliverEvent(Event event, Entity entity, DataType... args) {
-	systemManager.deliverEvent(event, entity, shared_from_this(), args...);
+	systemManager.deliverEvent(event, entity, WorldRef(*this), args...);
 }
 
 } // namespace Saga
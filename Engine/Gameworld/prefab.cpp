@@ -0,0 +1,20 @@
+#include "prefab.h"
+#include "gameworld.h"
+
+namespace Saga {
+
+Entity Prefab::instantiate(std::shared_ptr<GameWorld> world) const {
+	Entity entity = world->createEntity();
+	for (auto& component : components)
+		component->instantiate(*world, std::span<const Entity>(&entity, 1));
+	return entity;
+}
+
+std::vector<Entity> Prefab::instantiate(std::shared_ptr<GameWorld> world, std::size_t count) const {
+	std::vector<Entity> entities = world->createEntities(count);
+	for (auto& component : components)
+		component->instantiate(*world, entities);
+	return entities;
+}
+
+} // namespace Saga
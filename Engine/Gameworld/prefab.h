@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <span>
+#include <vector>
+#include "../Entity/entity.h"
+
+namespace Saga {
+
+class GameWorld;
+
+/**
+ * @brief Generic frozen component of a Prefab.
+ */
+class IPrefabComponent {
+public:
+	/**
+	 * @brief Destroy the IPrefabComponent object.
+	 */
+	virtual ~IPrefabComponent() = default;
+
+	/**
+	 * @brief Emplace a copy of the component onto each of a list of entities.
+	 *
+	 * @param world
+	 * @param entities entities that do not have this component yet.
+	 */
+	virtual void instantiate(GameWorld& world, std::span<const Entity> entities) const = 0;
+};
+
+/**
+ * @brief A frozen value of a single component type, copied onto every instance of a Prefab.
+ *
+ * @tparam Component the type of the component.
+ */
+template <typename Component>
+class PrefabComponent : public IPrefabComponent {
+public:
+	/**
+	 * @brief Construct a new PrefabComponent object.
+	 *
+	 * @param component the value that instances start out with.
+	 */
+	PrefabComponent(Component&& component) : component(std::move(component)) {}
+
+	virtual void instantiate(GameWorld& world, std::span<const Entity> entities) const override;
+
+	Component component; //!< the value that instances start out with.
+};
+
+/**
+ * @brief A frozen set of component values, captured once and copied onto new entities.
+ *
+ * Building an entity from scratch can be expensive: loading a Mesh parses its file, and a Texture reads its image from disk.
+ * A prefab does that work once, when its components are emplaced. Instantiating it then copies each component,
+ * so resources that components hold through shared pointers, like meshes, materials, shaders and textures, are shared by every instance instead of being loaded again.
+ * Instantiating many entities at once goes through GameWorld::emplaceBulk(), once per component type.
+ *
+ * Values that differ between instances, like the position, are set on the new entities after instantiating them.
+ * Components are emplaced in the order they were added to the prefab.
+ */
+class Prefab {
+public:
+	/**
+	 * @brief Construct a component of the prefab. Every instance starts out with a copy of it.
+	 *
+	 * @tparam Component the type of the component. Must be copy constructible, and not already be part of the prefab.
+	 * @tparam Args the types of the parameters used to construct the component.
+	 * @param args the parameters used to construct the component.
+	 * @return Component* the frozen component, which can still be tweaked before the prefab is instantiated.
+	 * The pointer stays valid for as long as the prefab does.
+	 */
+	template <typename Component, typename... Args>
+	Component* emplace(Args &&...args);
+
+	/**
+	 * @brief Get a component of the prefab.
+	 *
+	 * @tparam Component the type of the component.
+	 * @return Component* the frozen component, or nullptr if the prefab does not have one of this type.
+	 */
+	template <typename Component>
+	Component* get();
+
+	/**
+	 * @brief Create an entity with a copy of every component of the prefab.
+	 *
+	 * @param world
+	 * @return Entity the new entity.
+	 */
+	Entity instantiate(std::shared_ptr<GameWorld> world) const;
+
+	/**
+	 * @brief Create several entities with a copy of every component of the prefab.
+	 * Each component type is emplaced onto all of them at once, so containers and groups are updated once per type.
+	 *
+	 * @param world
+	 * @param count the number of entities to create.
+	 * @return std::vector<Entity> the new entities.
+	 */
+	std::vector<Entity> instantiate(std::shared_ptr<GameWorld> world, std::size_t count) const;
+
+	/**
+	 * @return std::size_t the number of components in the prefab.
+	 */
+	std::size_t size() const { return components.size(); }
+
+private:
+	std::vector<std::unique_ptr<IPrefabComponent>> components; //!< components of the prefab, in the order they are emplaced onto instances.
+};
+
+} // namespace Saga
+
+#include "prefab.inl"
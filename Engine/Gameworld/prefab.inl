@@ -0,0 +1,34 @@
+#pragma once
+
+#include <type_traits>
+#include "prefab.h"
+#include "gameworld.h"
+#include "../_Core/asserts.h"
+
+namespace Saga {
+
+template <typename Component>
+void PrefabComponent<Component>::instantiate(GameWorld& world, std::span<const Entity> entities) const {
+	world.emplaceBulk<Component>(entities, component);
+}
+
+template <typename Component, typename... Args>
+Component* Prefab::emplace(Args &&...args) {
+	static_assert(std::is_copy_constructible_v<Component>, "Components of a prefab are copied onto every instance, so they must be copy constructible.");
+	SASSERT_MESSAGE(!get<Component>(), "Prefab already has a component of the same type. You cannot have multiple of the same component type in the same prefab.");
+	auto component = std::make_unique<PrefabComponent<Component>>(Component(std::forward<Args>(args)...));
+	Component* frozen = &component->component;
+	components.push_back(std::move(component));
+	return frozen;
+}
+
+template <typename Component>
+Component* Prefab::get() {
+	// prefabs hold a handful of components, so a linear search is enough
+	for (auto& component : components)
+		if (auto* frozen = dynamic_cast<PrefabComponent<Component>*>(component.get()))
+			return &frozen->component;
+	return nullptr;
+}
+
+} // namespace Saga
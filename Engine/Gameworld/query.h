@@ -0,0 +1,201 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "../Entity/entity.h"
+#include "../Datastructures/typeOrder.h"
+#include "signature.h"
+#include "componentContainer.h"
+
+namespace Saga {
+
+class GameWorld;
+
+class IComponentContainer;
+
+template<typename Component>
+class ComponentContainer;
+
+template<typename... Component>
+class ComponentGroup;
+
+/**
+ * @brief Components that entities matching a Query must have. A pointer to each is yielded by the query.
+ * Yielding a component is a mutable access, which marks it as changed, unless the component is listed as const, like With<const Transform>.
+ */
+template <typename... Component>
+struct With {};
+
+/**
+ * @brief Components that entities matching a Query must not have.
+ */
+template <typename... Component>
+struct Without {};
+
+/**
+ * @brief Components that entities matching a Query may have. A pointer to each is yielded by the query, which is null if the entity does not have it.
+ * Like With, components that are not listed as const are marked as changed when yielded.
+ */
+template <typename... Component>
+struct Optional {};
+
+/**
+ * @brief Components that entities matching a Query must have, and that were changed or added since the query's tick.
+ */
+template <typename... Component>
+struct Changed {};
+
+/**
+ * @brief Components that entities matching a Query must have, and that were added since the query's tick.
+ */
+template <typename... Component>
+struct Added {};
+
+/**
+ * @brief Gathers every filter of one kind, such as every With<...>, into a single filter of that kind.
+ *
+ * @tparam Kind With, Without, Optional, Changed or Added.
+ * @tparam Filter the filters passed to a query, in any order.
+ */
+template <template <typename...> class Kind, typename... Filter>
+struct CollectFilters { using type = Kind<>; };
+
+template <template <typename...> class Kind, typename... Component, typename... Rest>
+struct CollectFilters<Kind, Kind<Component...>, Rest...> {
+	template <typename Collected> struct Prepend;
+	template <typename... Others> struct Prepend<Kind<Others...>> { using type = Kind<Component..., Others...>; };
+	using type = typename Prepend<typename CollectFilters<Kind, Rest...>::type>::type;
+};
+
+template <template <typename...> class Kind, typename Other, typename... Rest>
+struct CollectFilters<Kind, Other, Rest...> : CollectFilters<Kind, Rest...> {};
+
+template <typename Required, typename Excluded, typename Optionals, typename Changes, typename Additions>
+class Query;
+
+/**
+ * @brief The Query type that GameWorld::query() returns for a list of filters.
+ *
+ * @tparam Filter any number of With, Without, Optional, Changed and Added, in any order.
+ */
+template <typename... Filter>
+using QueryOf = Query<typename CollectFilters<With, Filter...>::type, typename CollectFilters<Without, Filter...>::type, 
+	typename CollectFilters<Optional, Filter...>::type, typename CollectFilters<Changed, Filter...>::type, typename CollectFilters<Added, Filter...>::type>;
+
+/**
+ * @brief Iterates through every entity that has all of the Required components and none of the Excluded ones,
+ * yielding a tuple of the Entity, a pointer to each Required component, and a pointer to each Optional component, which can be null.
+ * Changes and Additions narrow this down to entities whose components of those types were changed or added at or after a given tick.
+ *
+ * No group has to be registered beforehand. A query with Changes or Additions is driven by the container of the first of them, 
+ * whose ticks are tested before anything else. Otherwise, if a group is registered for the Required components, it drives the iteration.
+ * Failing that, the smallest container among the Required components does, and each of its entities is tested against the query's signatures.
+ * Tags (see isTag) have nothing to walk, so they never drive a query: one made only of tags tests every entity of the world, and yields the tags' shared instances.
+ * A query over several components that runs often without a group registers one at the next entityCleanup, backfilled from existing entities.
+ *
+ * Like groups, the pointers are only valid until components of these types are added or removed from the world.
+ *
+ * @tparam Required the components in With, in the order they are yielded.
+ * @tparam Excluded the components in Without.
+ * @tparam Optionals the components in Optional, in the order they are yielded after the Required ones.
+ * @tparam Changes the components in Changed.
+ * @tparam Additions the components in Added.
+ */
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+class Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>> {
+	static_assert(sizeof...(Required) > 0, "A query needs at least one component in With<...>.");
+	static_assert(!(isTag<Changes> || ...) && !(isTag<Additions> || ...), "Tags have no ticks, so they cannot be in Changed<...> or Added<...>.");
+	using Group = typename SortedTypes<std::remove_const_t<Required>...>::template As<ComponentGroup>; //!< the group that stores entities with the Required components.
+public:
+	static constexpr int GROUP_THRESHOLD = 16; //!< number of times a query can run without a group, before one is registered for it.
+
+	/**
+	 * @brief Iterates through the matching entities, skipping candidates that do not match.
+	 */
+	class iterator {
+	public:
+		using value_type = std::tuple<Entity, Required*..., Optionals*...>;
+
+		iterator(Query* query, std::size_t index) : query(query), index(index) { skip(); }
+
+		/**
+		 * @return value_type& the entry the iterator points to. This lives inside the iterator.
+		 */
+		value_type& operator*() { return current; }
+		iterator& operator++() { index++; skip(); return *this; }
+		bool operator==(const iterator& other) const { return index == other.index; }
+		bool operator!=(const iterator& other) const { return index != other.index; }
+
+	private:
+		Query* query;
+		std::size_t index; //!< position among the query's candidates.
+		value_type current; //!< the entry being pointed to, filled in when a matching candidate is found.
+
+		/**
+		 * @brief Move forward to the first candidate, starting from the current one, that matches the query.
+		 */
+		void skip();
+	};
+
+	/**
+	 * @brief Construct a new Query over a world.
+	 *
+	 * @param world
+	 * @param since the tick that Changed and Added filters compare against. Components stamped at this tick or later pass.
+	 */
+	Query(GameWorld& world, std::uint32_t since);
+
+	/**
+	 * @brief Start iterating through the query. If a group drives the query, its indices are brought up to date first.
+	 */
+	iterator begin();
+	iterator end() { return iterator(this, candidateCnt()); }
+
+	/**
+	 * @return true if a registered group drives this query.
+	 * @return false if the smallest container does.
+	 */
+	bool usesGroup() const { return group != nullptr; }
+
+private:
+	GameWorld& world;
+	std::tuple<ComponentContainer<std::remove_const_t<Required>>*...> required; //!< containers of the required components.
+	std::tuple<ComponentContainer<std::remove_const_t<Optionals>>*...> optionals; //!< containers of the optional components.
+	std::tuple<ComponentContainer<Changes>*...> changes; //!< containers of the components in Changed.
+	std::tuple<ComponentContainer<Additions>*...> additions; //!< containers of the components in Added.
+	std::array<int, sizeof...(Optionals)> optionalIds; //!< component ids of the optional components.
+	std::uint32_t since; //!< the tick that Changed and Added filters compare against.
+	Signature include; //!< components an entity must have, including the ones in Changed and Added.
+	Signature exclude; //!< components an entity must not have.
+	Group* group = nullptr; //!< the registered group for the required components, if any.
+	const std::vector<Entity>* candidates = nullptr; //!< when there is no group, the entities of the container driving the query.
+	const IComponentContainer* tickDriver = nullptr; //!< when a container in Changed or Added drives the query, that container.
+
+	/**
+	 * @return std::size_t the number of entities the query has to look at.
+	 */
+	std::size_t candidateCnt() const;
+
+	/**
+	 * @param index a position among the candidates.
+	 * @param cnt the number of candidates.
+	 * @return std::size_t the first candidate from index onwards that can match, or cnt if there is none. 
+	 * When a container in Changed or Added drives the query, candidates whose tick is too old are skipped. Otherwise this is index.
+	 */
+	std::size_t nextCandidate(std::size_t index, std::size_t cnt) const;
+
+	/**
+	 * @brief Test a candidate against the query, and fill in its entry if it matches.
+	 *
+	 * @param index a position in the range [0, candidateCnt()).
+	 * @param entry where to write the entry.
+	 * @return true if the candidate matches.
+	 * @return false otherwise, in which case entry may be partially written.
+	 */
+	bool tryEntry(std::size_t index, typename iterator::value_type& entry);
+};
+
+} // namespace Saga
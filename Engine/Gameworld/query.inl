@@ -0,0 +1,165 @@
+#pragma once
+
+#include <limits>
+#include <mutex>
+#include <utility>
+#include "query.h"
+#include "gameworld.h"
+#include "componentContainer.h"
+#include "componentGroup.h"
+
+namespace Saga {
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::Query(GameWorld& world, std::uint32_t since)
+	: world(world), required(world.viewAll<std::remove_const_t<Required>>().get()...), 
+	  optionals(world.viewAll<std::remove_const_t<Optionals>>().get()...),
+	  changes(world.viewAll<Changes>().get()...), additions(world.viewAll<Additions>().get()...),
+	  optionalIds{ world.getTypeId<std::remove_const_t<Optionals>>()... }, since(since),
+	  include(world.createSignature<std::remove_const_t<Required>..., Changes..., Additions...>()), exclude(world.createSignature<Excluded...>()) {
+
+	// the driver's ticks can be read by index, which rules most candidates out before any lookup
+	if constexpr (sizeof...(Changes) > 0) {
+		tickDriver = std::get<0>(changes);
+		candidates = &std::get<0>(changes)->getEntities().entities();
+		return;
+	} else if constexpr (sizeof...(Additions) > 0) {
+		tickDriver = std::get<0>(additions);
+		candidates = &std::get<0>(additions)->getEntities().entities();
+		return;
+	}
+
+	std::size_t slot = Group::getSlot();
+	if (slot < world.groupSlots.size() && world.groupSlots[slot]) {
+		group = static_cast<Group*>(world.groupSlots[slot].get());
+		return;
+	}
+
+	// every match has all the required components, so the smallest container has the fewest candidates.
+	// Tags have no container to walk, so a query made only of tags walks every entity.
+	candidates = &world.entitySlots;
+	std::size_t smallest = std::numeric_limits<std::size_t>::max();
+	std::apply([&]<typename... C>(ComponentContainer<C>*... container) {
+		([&] {
+			if constexpr (!isTag<C>) {
+				if (container->size() >= smallest) return;
+				smallest = container->size();
+				candidates = &container->getEntities().entities();
+			}
+		}(), ...);
+	}, required);
+
+	// a single container is already as tight as a group would be
+	if constexpr (sizeof...(Required) > 1) {
+		std::lock_guard<std::mutex> lock(world.queryMutex);
+		if (++world.queryUses[slot] == GROUP_THRESHOLD) {
+			// registering a group walks the world, so it waits until no System is iterating
+			world.pendingGroups.push_back([](GameWorld& world) {
+				std::size_t slot = Group::getSlot();
+				if (slot >= world.groupSlots.size() || !world.groupSlots[slot]) world.registerGroup<std::remove_const_t<Required>...>();
+			});
+		}
+	}
+}
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+typename Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::iterator Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::begin() {
+	if (group) group->begin();
+	return iterator(this, 0);
+}
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+std::size_t Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::candidateCnt() const {
+	if (group) return group->size();
+	return candidates ? candidates->size() : 0;
+}
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+std::size_t Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::nextCandidate(std::size_t index, std::size_t cnt) const {
+	// the driver's ticks line up with the candidates, so stale ones are skipped without looking anything up
+	if constexpr (sizeof...(Changes) > 0) {
+		while (index < cnt && tickDriver->getChangedTick(index) < since) index++;
+	} else if constexpr (sizeof...(Additions) > 0) {
+		while (index < cnt && tickDriver->getAddedTick(index) < since) index++;
+	}
+	return index;
+}
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+bool Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::tryEntry(std::size_t index, typename iterator::value_type& entry) {
+	Entity entity;
+	std::tuple<std::remove_const_t<Required>*...> components;
+	if (group) {
+		// members of the group have every required component, so only the other filters are left to test
+		typename Group::iterator it(group, index);
+		auto& groupEntry = *it;
+		entity = std::get<Entity>(groupEntry);
+		const Signature& signature = world.getSignature(entity);
+		if constexpr (sizeof...(Changes) + sizeof...(Additions) > 0)
+			if ((signature & include) != include) return false;
+		if constexpr (sizeof...(Excluded) > 0)
+			if ((signature & exclude).any()) return false;
+		components = std::tuple<std::remove_const_t<Required>*...>(std::get<std::remove_const_t<Required>*>(groupEntry)...);
+	} else {
+		entity = (*candidates)[index];
+		const Signature& signature = world.getSignature(entity);
+		if ((signature & include) != include) return false;
+		if constexpr (sizeof...(Excluded) > 0)
+			if ((signature & exclude).any()) return false;
+		components = std::apply([&]<typename... C>(ComponentContainer<C>*... container) {
+			return std::tuple<std::remove_const_t<Required>*...>([&]() -> C* {
+				if constexpr (isTag<C>) return &tagInstance<C>;
+				else return &container->at(container->getIndex(entity));
+			}()...);
+		}, required);
+	}
+
+	if constexpr (sizeof...(Changes) > 0) {
+		bool changed = std::apply([&](auto*... container) {
+			return ((container->getChangedTick(container->getIndex(entity)) >= since) && ...);
+		}, changes);
+		if (!changed) return false;
+	}
+	if constexpr (sizeof...(Additions) > 0) {
+		bool added = std::apply([&](auto*... container) {
+			return ((container->getAddedTick(container->getIndex(entity)) >= since) && ...);
+		}, additions);
+		if (!added) return false;
+	}
+
+	// the entity matches. Handing out non-const components counts as changing them.
+	[&]<std::size_t... column>(std::index_sequence<column...>) {
+		([&] {
+			using C = std::tuple_element_t<column, std::tuple<Required...>>;
+			if constexpr (!std::is_const_v<C> && !isTag<C>) {
+				auto* container = std::get<column>(required);
+				container->markChanged(container->getIndex(entity));
+			}
+		}(), ...);
+	}(std::index_sequence_for<Required...>{});
+
+	const Signature& signature = world.getSignature(entity);
+	auto optionalComponents = [&]<std::size_t... column>(std::index_sequence<column...>) {
+		return std::tuple<Optionals*...>([&]() -> std::tuple_element_t<column, std::tuple<Optionals*...>> {
+			using C = std::tuple_element_t<column, std::tuple<Optionals...>>;
+			if (!signature[optionalIds[column]]) return nullptr;
+			if constexpr (isTag<C>) return &tagInstance<std::remove_const_t<C>>;
+			auto* container = std::get<column>(optionals);
+			std::uint32_t componentIndex = container->getIndex(entity);
+			if constexpr (!std::is_const_v<C>)
+				container->markChanged(componentIndex);
+			return &container->at(componentIndex);
+		}()...);
+	}(std::index_sequence_for<Optionals...>{});
+
+	entry = std::tuple_cat(std::make_tuple(entity), std::tuple<Required*...>(components), optionalComponents);
+	return true;
+}
+
+template <typename... Required, typename... Excluded, typename... Optionals, typename... Changes, typename... Additions>
+void Query<With<Required...>, Without<Excluded...>, Optional<Optionals...>, Changed<Changes...>, Added<Additions...>>::iterator::skip() {
+	std::size_t cnt = query->candidateCnt();
+	while ((index = query->nextCandidate(index, cnt)) < cnt && !query->tryEntry(index, current)) index++;
+}
+
+} // namespace Saga
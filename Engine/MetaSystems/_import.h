@@ -1,3 +1,4 @@
 #pragma once
 
-#include "physics.h"
\ No newline at end of file
+#include "physics.h"
+#include "hierarchy.h"
@@ -0,0 +1,137 @@
+#include "hierarchy.h"
+#include "../Gameworld/gameworld.h"
+#include "../_Core/asserts.h"
+#include "Engine/Components/hierarchy.h"
+#include "Engine/Components/transform.h"
+#include <algorithm>
+
+namespace Saga {
+
+namespace Hierarchy {
+	namespace {
+		/**
+		 * @return Component* the entity's component, or nullptr if it has none. Unlike getComponent(), this does not count as changing it.
+		 */
+		template <typename Component>
+		Component* find(GameWorld& world, ComponentContainer<Component>& container, Entity entity) {
+			if (!world.isAlive(entity)) return nullptr;
+			std::uint32_t index = container.getIndex(entity);
+			return index == SparseSet::NULL_INDEX ? nullptr : &container.at(index);
+		}
+
+		/**
+		 * @brief Walk the hierarchy breadth-first from its roots, listing every attached Transform after its parent's.
+		 */
+		void rebuild(GameWorld& world, TransformHierarchy& hierarchy) {
+			auto& transforms = *world.viewAll<Transform>();
+			auto& allChildren = *world.viewAll<Children>();
+			hierarchy.links.clear();
+
+			// roots are entities with children but no parent
+			std::vector<Entity> frontier;
+			for (auto &[entity, children] : world.query<With<const Children>, Without<Parent>>())
+				frontier.push_back(entity);
+			// entities whose parent was destroyed stay where they last were, relative to the world, and become roots themselves.
+			// this may run alongside other Systems, so their stale Parent is removed through the CommandBuffer
+			for (auto &[entity, parent] : world.query<With<const Parent>>()) {
+				if (world.isAlive(parent->entity)) continue;
+				Transform* transform = find(world, transforms, entity);
+				if (transform && transform->isAttached()) {
+					transform->setFromMatrix(transform->getModelMatrix());
+					transform->setAttached(false);
+				}
+				world.getCommands().removeComponent<Parent>(entity);
+				frontier.push_back(entity);
+			}
+
+			for (std::size_t i = 0; i < frontier.size(); i++) {
+				Entity entity = frontier[i];
+				Children* children = find(world, allChildren, entity);
+				if (!children) continue;
+
+				// destroyed children are only dropped here, so that a parent that keeps attaching short-lived children does not grow forever.
+				// The component itself is kept even if it ends up empty, as setParent() may be adding to it before a removal could be played back
+				std::erase_if(children->entities, [&](Entity child) { return !world.isAlive(child); });
+
+				const Transform* parentTransform = find(world, transforms, entity);
+				for (Entity child : children->entities) {
+					if (Transform* transform = find(world, transforms, child))
+						hierarchy.links.push_back({ transform, parentTransform });
+					frontier.push_back(child);
+				}
+			}
+
+			hierarchy.outdated = false;
+			hierarchy.lastReordered[0] = transforms.getLastReordered();
+			hierarchy.lastReordered[1] = world.viewAll<Parent>()->getLastReordered();
+			hierarchy.lastReordered[2] = allChildren.getLastReordered();
+		}
+	}
+
+	void setParent(std::shared_ptr<GameWorld> world, Entity child, Entity parent, bool keepWorldTransform) {
+		SASSERT_MESSAGE(child != parent, "An entity cannot be its own parent.");
+		Transform* childTransform = world->getComponent<Transform>(child);
+		Transform* parentTransform = world->getComponent<Transform>(parent);
+		SASSERT_MESSAGE(childTransform && parentTransform, "Both the child and the parent need a Transform.");
+		for (const Parent* ancestor = world->getComponent<Parent>(parent).get(); ancestor; ancestor = world->getComponent<Parent>(ancestor->entity).get())
+			SASSERT_MESSAGE(ancestor->entity != child, "Cannot attach an entity to one of its descendants.");
+
+		detach(world, child, keepWorldTransform);
+
+		if (keepWorldTransform)
+			childTransform->setFromMatrix(glm::inverse(parentTransform->getModelMatrix()) * childTransform->getModelMatrix());
+		childTransform->setAttached(true);
+
+		world->emplace<Parent>(child, Parent{ parent });
+		Children* children = world->getComponent<Children>(parent);
+		if (!children) children = world->emplace<Children>(parent);
+		children->entities.push_back(child);
+
+		world->resource<TransformHierarchy>().outdated = true;
+	}
+
+	void detach(std::shared_ptr<GameWorld> world, Entity child, bool keepWorldTransform) {
+		const Parent* parent = world->getComponent<Parent>(child).get();
+		if (!parent) return;
+
+		if (Children* siblings = world->getComponent<Children>(parent->entity)) {
+			std::erase(siblings->entities, child);
+			if (siblings->entities.empty()) world->removeComponent<Children>(parent->entity);
+		}
+		world->removeComponent<Parent>(child);
+
+		if (Transform* transform = world->getComponent<Transform>(child)) {
+			if (keepWorldTransform) transform->setFromMatrix(transform->getModelMatrix());
+			transform->setAttached(false);
+		}
+
+		world->resource<TransformHierarchy>().outdated = true;
+	}
+
+	void destroyWithChildren(std::shared_ptr<GameWorld> world, Entity entity) {
+		if (const Children* children = world->getComponent<Children>(entity).get())
+			for (Entity child : children->entities)
+				if (world->isAlive(child)) destroyWithChildren(world, child);
+		world->destroyEntity(entity);
+	}
+
+	void propagate(std::shared_ptr<GameWorld> world) {
+		TransformHierarchy& hierarchy = world->resource<TransformHierarchy>();
+		if (hierarchy.outdated
+			|| hierarchy.lastReordered[0] != world->viewAll<Transform>()->getLastReordered()
+			|| hierarchy.lastReordered[1] != world->viewAll<Parent>()->getLastReordered()
+			|| hierarchy.lastReordered[2] != world->viewAll<Children>()->getLastReordered())
+			rebuild(*world, hierarchy);
+
+		// parents come first, so their matrices are final by the time their children read them
+		for (auto& [child, parent] : hierarchy.links) {
+			if (!parent) {
+				if (child->isDirty()) child->updateModelMatrix();
+			} else if (child->isStale(*parent)) {
+				child->updateModelMatrix(parent);
+			}
+		}
+	}
+}
+
+} // namespace Saga
@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Entity/entity.h"
+#include <memory>
+
+namespace Saga {
+
+class GameWorld;
+
+/**
+ * @brief Attaching entities to each other, so that their Transforms follow their parent's.
+ * See Parent and Children.
+ */
+namespace Hierarchy {
+	/**
+	 * @brief Attach an entity to another. Both must have a Transform. If the child was attached to another entity, it is detached from it first.
+	 * 
+	 * @param world 
+	 * @param child 
+	 * @param parent must not be the child, or one of its descendants.
+	 * @param keepWorldTransform if true, the child's Transform is changed so that it stays where it is in the world. 
+	 * 	Otherwise, its current position, rotation and scale become relative to the parent.
+	 */
+	void setParent(std::shared_ptr<GameWorld> world, Entity child, Entity parent, bool keepWorldTransform = false);
+
+	/**
+	 * @brief Detach an entity from its parent, if it has one.
+	 * 
+	 * @param world 
+	 * @param child 
+	 * @param keepWorldTransform if true, the child's Transform is changed so that it stays where it is in the world.
+	 * 	Otherwise, its position, rotation and scale, which were relative to the parent, become relative to the world.
+	 */
+	void detach(std::shared_ptr<GameWorld> world, Entity child, bool keepWorldTransform = true);
+
+	/**
+	 * @brief Destroy an entity, along with every entity attached to it, recursively.
+	 * Destroying only the parent leaves its children where they last were, relative to the world.
+	 * 
+	 * @param world 
+	 * @param entity 
+	 */
+	void destroyWithChildren(std::shared_ptr<GameWorld> world, Entity entity);
+
+	/**
+	 * @brief Rebuild the model matrix of every attached Transform that changed, or whose parent's model matrix was rebuilt.
+	 * Transforms without a parent must be up to date before this is called. The transformSystem calls this after rebuilding them.
+	 * Subtrees that did not move are skipped without rebuilding anything.
+	 * 
+	 * @param world 
+	 */
+	void propagate(std::shared_ptr<GameWorld> world);
+}
+
+} // namespace Saga
@@ -8,3 +8,5 @@
 #include "drawSystem.h"
 #include "events.h"
 #include "system.h"
+#include "systemAccess.h"
+#include "transformSystem.h"
@@ -6,9 +6,15 @@
 
 namespace Saga::Systems {
 
-void registerAISystems(std::shared_ptr<GameWorld> world) {
+void registerAISystems(std::shared_ptr<GameWorld> world, SystemAccess access) {
     world->registerGroup<Saga::BehaviourTree, Saga::Blackboard>();
-    world->getSystems().addStagedSystem(System<float,float>(AIupdateSystem), SystemManager::Stage::Update);
+    // behaviour tree nodes are user code, so only the caller knows what they touch. Without a declaration, they cannot be trusted to run concurrently either
+    if (access.isExclusive()) {
+        world->getSystems().addStagedSystem(System<float,float>(AIupdateSystem), SystemManager::Stage::Update, access);
+        return;
+    }
+    access.write<Saga::BehaviourTree, Saga::Blackboard>();
+    world->getSystems().addStagedSystem(System<float,float>(AIparallelUpdateSystem), SystemManager::Stage::Update, access);
 }
 
 void AIupdateSystem(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
@@ -21,4 +27,15 @@ void AIupdateSystem(std::shared_ptr<GameWorld> world, float deltaTime, float tim
     }
 }
 
+void AIparallelUpdateSystem(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
+    // each tree only works on its own blackboard, so trees are ticked in parallel
+    world->parallelEach<Saga::BehaviourTree, Saga::Blackboard>([&](Entity entity, Saga::BehaviourTree* behaviourTree, Saga::Blackboard* blackboard) {
+        blackboard->entity = entity;
+        blackboard->world = world;
+        blackboard->time = time;
+        blackboard->deltaTime = deltaTime;
+        behaviourTree->update(*blackboard);
+    });
+}
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include "systemAccess.h"
 
 namespace Saga {
     class GameWorld;
@@ -13,12 +14,16 @@ namespace Saga::Systems {
      *
      * @ingroup system
      * @param world
+     * @param access components the behaviour tree nodes read and write, on top of the trees and blackboards themselves.
+     * If nothing is declared, behaviour trees update alone, one after the other, with AIupdateSystem. 
+     * Otherwise they are updated in parallel with AIparallelUpdateSystem.
      */
-    void registerAISystems(std::shared_ptr<GameWorld> world );
+    void registerAISystems(std::shared_ptr<GameWorld> world, SystemAccess access = SystemAccess());
 
     /**
      * @brief Updates AI systems in the world. This includes updating 
      * all behaviour trees, which includes running update on its root.
+     * Trees are updated one after the other, on the calling thread.
      *
 	 * @ingroup system
 	 * @param world 
@@ -26,4 +31,15 @@ namespace Saga::Systems {
 	 * @param time time since start of the program.
      */
     void AIupdateSystem(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+
+    /**
+     * @brief Same as AIupdateSystem, but trees of different entities are updated in parallel. Behaviour nodes must only touch 
+     * the components declared to registerAISystems, and must record structural changes in the world's CommandBuffer rather than applying them directly.
+     *
+	 * @ingroup system
+	 * @param world 
+	 * @param deltaTime time since last update.
+	 * @param time time since start of the program.
+     */
+    void AIparallelUpdateSystem(std::shared_ptr<GameWorld> world, float deltaTime, float time);
 }
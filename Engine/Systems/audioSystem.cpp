@@ -18,16 +18,13 @@ namespace Saga::Systems {
 		}
 	}
 
-	void audioEmitterUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
-		for (auto& [entity, audioEmitter, transform] : *world->viewGroup<AudioEmitter, Transform>()) {
+	void audioEmitterUpdate(WorldRef world, float deltaTime, float time) {
+		for (auto& [entity, audioEmitter, transform, rigidbody] : world->query<With<const AudioEmitter, const Transform>, Optional<const RigidBody>>()) {
 			if (audioEmitter->is3D && audioEmitter->audioInstance) {
 				glm::vec3 velocity(0,0,0);
 
 				// use velocity if rigidbody exists
-				if (world->hasComponent<RigidBody>(entity)) {
-					auto rigidbody = world->getComponent<RigidBody>(entity);
-					velocity = rigidbody->velocity;
-				}
+				if (rigidbody) velocity = rigidbody->velocity;
 
 				AudioEngine::set3DAttributes(audioEmitter->audioInstance, AudioEngine::EventAttributes(
 					transform->getPos(),
@@ -73,7 +70,8 @@ namespace Saga::Systems {
 	void setupAudioSystem(std::shared_ptr<GameWorld> world) {
 		registerAudioSystem(world);
 		world->getSystems().addStagedSystem(System<>(audioEmitterAwake), SystemManager::Stage::Awake);
-		world->getSystems().addStagedSystem(System<float, float>(audioEmitterUpdate), SystemManager::Stage::Update);
+		world->getSystems().addStagedSystem(RefSystem<float, float>(audioEmitterUpdate), SystemManager::Stage::Update,
+			SystemAccess().read<AudioEmitter, RigidBody, Transform>());
 		world->getSystems().addStagedSystem(System<>(audioEmitterUnload), SystemManager::Stage::Cleanup);
 	}
 };
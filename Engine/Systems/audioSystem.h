@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include "system.h"
 
 namespace Saga {
 class GameWorld;
@@ -22,7 +23,7 @@ namespace Saga::Systems {
 	 * @param deltaTime time since last update.
 	 * @param time time since start of the program.
 	 */
-	void audioEmitterUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+	void audioEmitterUpdate(WorldRef world, float deltaTime, float time);
 
 	/**
 	 * @brief Perform cleanup on the event emitters. 
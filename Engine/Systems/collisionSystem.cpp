@@ -16,10 +16,67 @@
 #include "glm/gtx/string_cast.hpp"
 #include <unordered_set>
 #include <functional>
+#include <algorithm>
+#include <utility>
 
 namespace Saga::Systems {
     // anonymous namespace
     namespace {
+        /**
+         * @brief Record that two entities collided during this step. Events for it are only delivered once resolution is done.
+         * 
+         * @param systemData 
+         * @param entity0 
+         * @param entity1 
+         */
+        void queueContact(CollisionSystemData& systemData, Entity entity0, Entity entity1) {
+            systemData.contacts.push_back(std::minmax(entity0, entity1));
+        }
+
+        /**
+         * @brief Deliver the collision events of every pair queued during this step, once per pair.
+         * Pairs are compared against the previous step to tell whether they just entered, stayed in, or exited collision.
+         * 
+         * @param world 
+         * @param systemData 
+         */
+        void dispatchContacts(std::shared_ptr<GameWorld> world, CollisionSystemData& systemData) {
+            std::vector<std::pair<Entity, Entity>> current = std::move(systemData.contacts);
+            std::vector<std::pair<Entity, Entity>> last = std::move(systemData.lastContacts);
+            systemData.contacts.clear();
+
+            std::sort(current.begin(), current.end());
+            current.erase(std::unique(current.begin(), current.end()), current.end());
+
+            // queued rather than delivered, so that listeners run once the stage is over
+            auto deliver = [&](EngineEvents event, const std::pair<Entity, Entity>& pair) {
+                world->getEvents().deliver(event, pair.first, pair.second);
+                world->getEvents().deliver(event, pair.second, pair.first);
+            };
+
+            // both lists are sorted, so a single merge tells which pairs are new, which persist, and which are gone
+            auto itCurrent = current.begin(), itLast = last.begin();
+            while (itCurrent != current.end() || itLast != last.end()) {
+                if (itLast == last.end() || (itCurrent != current.end() && *itCurrent < *itLast)) {
+                    deliver(EngineEvents::OnCollisionEnter, *itCurrent);
+                    deliver(EngineEvents::OnCollision, *itCurrent);
+                    itCurrent++;
+                } else if (itCurrent == current.end() || *itLast < *itCurrent) {
+                    deliver(EngineEvents::OnCollisionExit, *itLast);
+                    itLast++;
+                } else {
+                    deliver(EngineEvents::OnCollisionStay, *itCurrent);
+                    deliver(EngineEvents::OnCollision, *itCurrent);
+                    itCurrent++, itLast++;
+                }
+            }
+
+            // keep the old buffer's capacity around for the next step
+            last.clear();
+            systemData.contacts = std::move(last);
+            systemData.lastContacts = std::move(current);
+        }
+
         /**
          * @brief Detect collision between two axis-aligned cylinder colliders, and return the mtv such that if the first cylinder is translated by the mtv, the two objects no longer collide.
          * 
@@ -30,11 +87,11 @@ namespace Saga::Systems {
          * @return glm::vec3 zero if the two cylinders are not colliding. Otherwise the mtv.
          */
         glm::vec3 detectCollision(
-                CylinderCollider &a, Transform &aTransform, 
-                CylinderCollider &b, Transform &bTransform) {
+                const CylinderCollider &a, Transform &aTransform, 
+                const CylinderCollider &b, Transform &bTransform) {
 
-            return Saga::Geometry::detectAACylinderCylinderCollision(a.height, a.radius, aTransform.transform->getPos(),
-                    b.height, b.radius, bTransform.transform->getPos());
+            return Saga::Geometry::detectAACylinderCylinderCollision(a.height, a.radius, aTransform.getPos(),
+                    b.height, b.radius, bTransform.getPos());
         }
 
         /**
@@ -53,7 +110,7 @@ namespace Saga::Systems {
                 Entity entityEllipsoid, Transform& transform, EllipsoidCollider& ellipsoidCollider, 
                 RigidBody& rigidBody, glm::vec3 move) {
 
-            glm::vec3 curPos = transform.transform->getPos();
+            glm::vec3 curPos = transform.getPos();
             glm::vec3 nextPos = curPos + move;
 
             const int MAX_TRANSLATIONS = 10;
@@ -65,7 +122,7 @@ namespace Saga::Systems {
                 if (cylinderCollider) cylinder = cylinderCollider;
             }
 
-            auto sysData = getSystemData(world);
+            CollisionSystemData& sysData = getSystemData(world);
 
             for (int i = 0; i < MAX_TRANSLATIONS; i++) {
                 glm::vec3 dir = nextPos - curPos;
@@ -90,8 +147,7 @@ namespace Saga::Systems {
                     // also adjust velocity so there wouldn't be any in the collision normal direction
                     rigidBody.velocity -= glm::dot(rigidBody.velocity, collision->normal) * collision->normal;
 
-                    world->deliverEvent(EngineEvents::OnCollision, collision->entity0, collision->entity1);
-                    world->deliverEvent(EngineEvents::OnCollision, collision->entity1, collision->entity0);
+                    queueContact(sysData, collision->entity0, collision->entity1);
                     STRACE("collision between %d, %d", collision->entity0, collision->entity1);
                 }
             }
@@ -114,12 +170,11 @@ namespace Saga::Systems {
 
             auto handleCollision = 
             []( std::shared_ptr<GameWorld> world, glm::vec3 mtv,
-                auto entity0, auto collider0, auto cylinderCollider0, auto rigidbody0, auto transform0,
-                auto entity1, auto collider1, auto cylinderCollider1, auto rigidbody1, auto transform1) {
+                auto entity0, auto collider0, auto cylinderCollider0, auto rigidbody0, auto transform0, EllipsoidCollider* ellipsoid0,
+                auto entity1, auto collider1, auto cylinderCollider1, auto rigidbody1, auto transform1, EllipsoidCollider* ellipsoid1) {
 
-                // deliver the collision events to the two entities
-                world->deliverEvent(EngineEvents::OnCollision, entity0, entity1);
-                world->deliverEvent(EngineEvents::OnCollision, entity1, entity0);
+                // the collision events are delivered once resolution is done
+                queueContact(getSystemData(world), entity0, entity1);
 
                 float eps = 0.001f;
                 // default to moving both by 0.5
@@ -129,16 +184,13 @@ namespace Saga::Systems {
                 if (rigidbody0->isStatic()) move1 = 1 + eps, move0 = 0;
                 if (rigidbody1->isStatic()) move0 = 1 + eps, move1 = 0;
 
-                EllipsoidCollider* ellipsoid0 = world->getComponent<EllipsoidCollider>(entity0);
-                EllipsoidCollider* ellipsoid1 = world->getComponent<EllipsoidCollider>(entity1);
-
                 if (ellipsoid0) { 
                     ellipsoidTriangleCollisions(world, entity0, *transform0, *ellipsoid0, *rigidbody0, mtv*move0);
-                } else transform0->transform->translate(mtv * move0);
+                } else transform0->translate(mtv * move0);
 
                 if (ellipsoid1) {
                     ellipsoidTriangleCollisions(world, entity1, *transform1, *ellipsoid1, *rigidbody1, mtv*move1);
-                } else transform1->transform->translate(-mtv * move1);
+                } else transform1->translate(-mtv * move1);
 
             };
 
@@ -147,16 +199,12 @@ namespace Saga::Systems {
             // only resolve 10 collisions per frame at most
             while (collisionResolvingCount > 0) {
                 bool collisionDetected = false;
-                auto &group = *world->viewGroup<Saga::Collider,Saga::CylinderCollider, Saga::RigidBody, Saga::Transform>();
-                for (auto &[entity0, collider0, cylinderCollider0, rigidbody0, transform0] : group) 
-                    for (auto &[entity1, collider1, cylinderCollider1, rigidbody1, transform1] : group) 
+                auto cylinders = world->query<With<const Collider, const CylinderCollider, RigidBody, Transform>, Optional<EllipsoidCollider>>();
+                for (auto &[entity0, collider0, cylinderCollider0, rigidbody0, transform0, ellipsoid0] : cylinders) 
+                    for (auto &[entity1, collider1, cylinderCollider1, rigidbody1, transform1, ellipsoid1] : cylinders) 
 
                     if (!collisionPair.count(std::make_pair(entity0, entity1))) {
 
-                        // null checks
-                        SASSERT_MESSAGE(transform0->transform, "Transform cannot be null.");
-                        SASSERT_MESSAGE(transform1->transform, "Transform cannot be null.");
-
                         // only detect collision if one of the objects is not static
                         if (entity0 < entity1 && (!rigidbody0->isStatic() || !rigidbody1->isStatic())) {
                             // detect collision between the two cylinders
@@ -165,8 +213,8 @@ namespace Saga::Systems {
                             if (mtv != glm::vec3(0,0,0)) {
                                 collisionDetected = 1;
                                 handleCollision(world, mtv, 
-                                        entity0,collider0,  cylinderCollider0,  rigidbody0,  transform0,  
-                                        entity1,  collider1,  cylinderCollider1,  rigidbody1,  transform1);
+                                        entity0,collider0,  cylinderCollider0,  rigidbody0,  transform0,  ellipsoid0,
+                                        entity1,  collider1,  cylinderCollider1,  rigidbody1,  transform1,  ellipsoid1);
                                 if (collisionResolvingCount-- <= 0)
                                     goto endCollisions;
                                 collisionPair.insert(std::make_pair(entity0, entity1));
@@ -183,14 +231,17 @@ endCollisions: {}
 
     /**
      * @brief First handle cylinder-cylinder collision. Then handle all triangle-ellipsoid collisions.
+     * Collision events found along the way are queued at the end, once per colliding pair.
      */
     void collisionSystem(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
         for (auto &[entity, collider, ellipsoidCollider, rigidBody, transform] : *world->viewGroup<Collider, EllipsoidCollider, RigidBody, Transform>()) {
 
             glm::vec3 finalPos = ellipsoidTriangleCollisions(world, entity, *transform, 
                 *ellipsoidCollider, *rigidBody, deltaTime * rigidBody->velocity);
-            transform->transform->setPos(finalPos);
+            transform->setPos(finalPos);
         }
+
+        dispatchContacts(world, getSystemData(world));
     }
 
     /**
@@ -5,6 +5,7 @@
 #include "Engine/Systems/helpers/postProcessing.h"
 #include "Engine/Systems/helpers/shadowMap.h"
 #include "Engine/Systems/particleSystem.h"
+#include "Engine/Systems/transformSystem.h"
 #include "Engine/_Core/logger.h"
 #include "Graphics/GLWrappers/texture.h"
 #include "Graphics/global.h"
@@ -36,9 +37,8 @@ inline void renderAllShapes(std::shared_ptr<GameWorld> world) {
     for (auto &[entity, material, mesh, transform] : *world->viewGroup<Material, Mesh, Transform>()) {
         SASSERT_MESSAGE(material->material, "Material cannot be null.");
         SASSERT_MESSAGE(mesh->mesh, "Mesh shape cannot be null.");
-        SASSERT_MESSAGE(transform->transform, "Transform cannot be null.");
 
-        graphics.drawShape(*mesh, *transform, *material);
+        graphics.drawShape(*mesh, transform->getModelMatrix(), *material);
     }
 }
 
@@ -61,9 +61,8 @@ inline void renderScene(std::shared_ptr<GameWorld> world, Saga::Camera& camera,
     std::vector<std::shared_ptr<GraphicsEngine::Light>> lights;
     for (auto &[entity, light, transform] : *world->viewGroup<Light, Transform>()) {
         SASSERT_MESSAGE(light->light, "Light reference cannot be null.");
-        SASSERT_MESSAGE(transform->transform, "Transform reference cannot be null.");
 
-        light->light->setPos(transform->transform->getPos());
+        light->light->setPos(transform->getPos());
         lights.push_back(light->light);
     }
     graphics.setLights(lights);
@@ -75,7 +74,7 @@ inline void renderScene(std::shared_ptr<GameWorld> world, Saga::Camera& camera,
         graphics.getActiveShader()->setSampler("shadowMap", 2);
         graphics.getActiveShader()->setMat4("lightSpaceMatrix", shadowMapLightSpaceMatrix.value());
 
-        auto drawData = world->getComponent<DrawSystemData>(world->getMasterEntity());
+        auto drawData = world->findResource<DrawSystemData>();
 
         if (drawData) {
             if (drawData->debugShadowMap)
@@ -93,7 +92,7 @@ inline void renderScene(std::shared_ptr<GameWorld> world, Saga::Camera& camera,
 
     {
         // draw skybox
-        auto drawData = world->getComponent<DrawSystemData>(world->getMasterEntity());
+        auto drawData = world->findResource<DrawSystemData>();
         if (drawData && drawData->skybox)
             drawData->skybox->draw(camera);
     }
@@ -112,7 +111,7 @@ void drawSystem_OnSetup(std::shared_ptr<GameWorld> world) {
     Graphics::shadowMapSetup(world);
     for (Saga::Camera& camera : *world->viewAll<Camera>())
         Graphics::postProcessingSetup(world, camera);
-    auto drawData = world->getComponent<DrawSystemData>(world->getMasterEntity());
+    auto drawData = world->findResource<DrawSystemData>();
     if (drawData) drawData->skybox = std::make_shared<Saga::Graphics::Skybox>("Resources/Images/skyboxes/universe/", "png");
 
     using namespace GraphicsEngine::Global;
@@ -124,7 +123,7 @@ void drawSystem_OnSetup(std::shared_ptr<GameWorld> world) {
 void drawSystem(std::shared_ptr<Saga::GameWorld> world) {
     ImGui::Begin("Draw System");
 
-    auto drawData = world->getComponent<DrawSystemData>(world->getMasterEntity());
+    auto drawData = world->findResource<DrawSystemData>();
     if (drawData) {
         ImGui::Checkbox("Debug Shadow Map", &drawData->debugShadowMap);
     }
@@ -146,8 +145,11 @@ void drawSystem_OnResize(std::shared_ptr<GameWorld> world, int width, int height
 }
 
 void registerDrawSystem(std::shared_ptr<GameWorld> world) {
-    world->registerGroup<Material, Mesh, Transform>();
+    // the draw loops (shadow and main pass) visit every renderable entity each frame, so keep them packed
+    world->registerGroup<Material, Mesh, Transform>(GroupStorage::Packed);
     world->registerGroup<Light, Transform>();
+    // model matrices are rebuilt once, before the draw system's shadow and main passes read them
+    registerTransformSystem(world);
     world->getSystems().addStagedSystem(Saga::System<>(Saga::Systems::drawSystem), Saga::SystemManager::Stage::Draw);
     world->getSystems().addStagedSystem(Saga::System<>(Saga::Systems::drawSystem_OnSetup), Saga::SystemManager::Stage::Awake);
     world->getSystems().addWindowResizeSystem(Saga::Systems::drawSystem_OnResize);
@@ -7,6 +7,9 @@ namespace Saga {
 	 * \see ENGINE_EVENT_START_VALUE.
 	 */
 	enum class EngineEvents {
-		OnCollision = 1000
+		OnCollision = 1000, //!< delivered once per step to both entities of every pair that is colliding.
+		OnCollisionEnter, //!< delivered to both entities of a pair that collides this step, but did not the step before.
+		OnCollisionStay, //!< delivered to both entities of a pair that collides this step, and did the step before.
+		OnCollisionExit //!< delivered to both entities of a pair that collided the step before, but no longer does.
 	};
 }
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace Saga::Systems {
         if (!collisionSystemData.uniformGrid)
             collisionSystemData.uniformGrid = UniformGrid<Entity>();
 
-        auto allCylinders = *world->viewGroup<Collider, CylinderCollider, Transform>();
+        auto &allCylinders = *world->viewGroup<Collider, CylinderCollider, Transform>();
         for (auto [entity, collider, cylinderCollider, transform] : allCylinders) 
             addToUniformGrid(collisionSystemData, entity, *cylinderCollider, *transform);
     }
@@ -5,12 +5,8 @@
 
 namespace Saga::Systems {
     CollisionSystemData& getSystemData(std::shared_ptr<GameWorld> world) {
-        auto allCollisionSystemData = world->viewAll<CollisionSystemData>();
-        if (allCollisionSystemData->begin() == allCollisionSystemData->end()) {
-            // if no collision data object exists we create one
-            return *world->emplace<CollisionSystemData>(world->getMasterEntity());
-        }
-        return *allCollisionSystemData->begin();
+        // if no collision data exists yet, this creates it
+        return world->resource<CollisionSystemData>();
     }
 
     void rebuildStaticBVH(std::shared_ptr<GameWorld> world) {
@@ -29,7 +25,7 @@ namespace Saga::Systems {
 
                 // transform all triangles to world space
                 for (int j = 0; j < 3; j++)
-                    triangleData.triangle[j] = transform->transform->getModelMatrix() * glm::vec4(mesh->getPos(3*triangleIndex + j), 1);
+                    triangleData.triangle[j] = transform->getModelMatrix() * glm::vec4(mesh->getPos(3*triangleIndex + j), 1);
 
                 allTriangles.push_back(triangleData);
             }
@@ -12,9 +12,8 @@ namespace Saga {
 
 namespace Saga::Systems {
     /**
-     * @brief Retrieve the world's CollisionSystemData. This should live as
-     * a component on an entity. If none exists, the component will be created
-     * automatically on the master object of the world.
+     * @brief Retrieve the world's CollisionSystemData. This lives as a
+     * resource of the world, and is created automatically if none exists.
      *
      * @param world the world that the data exists on.
      *
@@ -24,9 +23,8 @@ namespace Saga::Systems {
 
     /**
      * @brief This builds the bounding volume hierarchy for all static meshes
-     * in the scene, and stores it inside of CollisionSystemData. This lives on an
-     * entity inside the world, and will create an entity to contain CollisionSystemData
-     * if one has not been created.
+     * in the scene, and stores it inside of CollisionSystemData. This lives as a
+     * resource of the world, and will be created if it does not exist yet.
      *
      * @param world
      */
@@ -24,10 +24,7 @@ void postProcessingSetup(std::shared_ptr<Saga::GameWorld> world, Camera& camera)
 
     int width = camera.camera->getWidth(), height = camera.camera->getHeight();
 
-    DrawSystemData* drawSystemData =
-        world->hasComponent<DrawSystemData>(world->getMasterEntity()) ?
-        world->getComponent<DrawSystemData>(world->getMasterEntity()) :
-        world->emplace<DrawSystemData>(world->getMasterEntity());
+    DrawSystemData* drawSystemData = &world->resource<DrawSystemData>();
 
     SINFO("Attempt to createframebuffers for post processing");
 
@@ -90,10 +87,7 @@ extractionFramebuffer: {
 void usePostProcessingFBO(std::shared_ptr<GameWorld> world) {
     using namespace GraphicsEngine::Global;
 
-    DrawSystemData* drawSystemData =
-        world->hasComponent<DrawSystemData>(world->getMasterEntity()) ?
-        world->getComponent<DrawSystemData>(world->getMasterEntity()) :
-        world->emplace<DrawSystemData>(world->getMasterEntity());
+    DrawSystemData* drawSystemData = &world->resource<DrawSystemData>();
 
     if (drawSystemData->postProcessingSettings.enabled)
         graphics.getFramebuffer(drawSystemData->postProcessingSettings.screenFramebuffer)->bind();
@@ -104,10 +98,7 @@ void usePostProcessingFBO(std::shared_ptr<GameWorld> world) {
 void performPostProcessing(std::shared_ptr<Saga::GameWorld> world, Camera& camera) {
     using namespace GraphicsEngine::Global;
     // configure viewport size
-    DrawSystemData* drawSystemData =
-        world->hasComponent<DrawSystemData>(world->getMasterEntity()) ?
-        world->getComponent<DrawSystemData>(world->getMasterEntity()) :
-        world->emplace<DrawSystemData>(world->getMasterEntity());
+    DrawSystemData* drawSystemData = &world->resource<DrawSystemData>();
 
     if (!drawSystemData->postProcessingSettings.enabled) return;
 
@@ -166,10 +157,7 @@ void performPostProcessing(std::shared_ptr<Saga::GameWorld> world, Camera& camer
 
 
 void drawPostProcessingGizmos(std::shared_ptr<Saga::GameWorld> world) {
-    DrawSystemData* drawSystemData =
-        world->hasComponent<DrawSystemData>(world->getMasterEntity()) ?
-        world->getComponent<DrawSystemData>(world->getMasterEntity()) :
-        world->emplace<DrawSystemData>(world->getMasterEntity());
+    DrawSystemData* drawSystemData = &world->resource<DrawSystemData>();
 
     ImGui::Checkbox("Enable post processing", &drawSystemData->postProcessingSettings.enabled);
 
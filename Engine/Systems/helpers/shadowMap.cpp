@@ -64,10 +64,7 @@ namespace Saga::Systems::Graphics {
         graphics.addFramebuffer("shadowMap", SHADOW_WIDTH, SHADOW_HEIGHT);
 
         // setup draw data
-        DrawSystemData* drawSystemData = 
-            world->hasComponent<DrawSystemData>(world->getMasterEntity()) ? 
-                world->getComponent<DrawSystemData>(world->getMasterEntity()) :
-                world->emplace<DrawSystemData>(world->getMasterEntity());
+        DrawSystemData* drawSystemData = &world->resource<DrawSystemData>();
 
         SINFO("Created frame buffer for shadow mapping");
         auto shadowMapFBO = graphics.getFramebuffer("shadowMap");
@@ -118,7 +115,7 @@ namespace Saga::Systems::Graphics {
 
             for (auto &[entity, material, mesh, transform] : *world->viewGroup<Material, Mesh, Transform>()) {
                 // we need only load the model matrix
-                graphics.getActiveShader()->setModelTransform(transform->transform->getModelMatrix());
+                graphics.getActiveShader()->setModelTransform(transform->getModelMatrix());
                 mesh->mesh->draw();
             }
         }
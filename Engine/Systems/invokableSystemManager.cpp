@@ -1,46 +1,94 @@
 #include "invokableSystemManager.h"
 #include <iostream>
+#include "../Gameworld/gameworld.h"
+#include "../_Core/jobSystem.h"
 
 namespace Saga {
 
-void InvokableSystemManager::runStageStartup(std::shared_ptr<GameWorld> gameWorld) {
-	stagedSystemsMap.invoke(Stage::Awake, gameWorld);
-	stagedSystemsMap.invoke(Stage::Start, gameWorld); 
+template <typename ...DataType>
+void InvokableSystemManager::runStage(Stage stage, WorldRef gameWorld, DataType... args) {
+	StageSchedule& schedule = getSchedule(stage);
+
+	// Systems that still take a shared_ptr all share this one, rather than each retrieving their own
+	std::shared_ptr<GameWorld> sharedWorld = gameWorld->weak_from_this().lock();
+
+	for (StageBatch& batch : schedule.batches) {
+		auto invoke = [&](std::uint32_t i) {
+			// events are ordered by the system's position, whichever thread it runs on
+			EventQueue::Source source(batch.begin + i);
+			StagedSystem& system = schedule.systems[batch.begin + i];
+			if (auto callback = Callback<WorldRef, DataType...>::cast(system.callback.get()))
+				callback->evoke(gameWorld, args...);
+			else if (auto callback = Callback<std::shared_ptr<GameWorld>, DataType...>::cast(system.callback.get()))
+				callback->evoke(sharedWorld, args...);
+			else SERROR("System %d in stage %d does not accept the arguments of the stage.", system.id, stage);
+		};
+
+		JobSystem& jobs = gameWorld->getJobs();
+		if (!batch.parallel || !jobs.getWorkerCnt()) {
+			for (std::uint32_t i = 0; i < batch.end - batch.begin; i++) invoke(i);
+			continue;
+		}
+
+		// containers have to exist before systems that run in parallel look them up
+		for (std::uint32_t i = batch.begin; i < batch.end; i++) schedule.systems[i].access.ensureContainers(*gameWorld);
+
+		// each system is a continuation of the earlier systems it conflicts with
+		std::vector<JobHandle> handles(batch.end - batch.begin);
+		std::vector<JobHandle> dependencies;
+		for (std::uint32_t i = 0; i < handles.size(); i++) {
+			dependencies.clear();
+			for (std::uint32_t j : batch.dependencies[i]) dependencies.push_back(handles[j]);
+			handles[i] = jobs.schedule([&invoke, i] { invoke(i); }, dependencies);
+		}
+		for (JobHandle& handle : handles) jobs.wait(handle);
+	}
+
+	// events raised by the stage's systems reach their listeners here, on the calling thread
+	gameWorld->getEvents().dispatch();
+}
+
+void InvokableSystemManager::runStageStartup(WorldRef gameWorld) {
+	runStage(Stage::Awake, gameWorld);
+	runStage(Stage::Start, gameWorld); 
 }
 
-void InvokableSystemManager::runStageUpdate(std::shared_ptr<GameWorld> gameWorld, float time, float deltaTime) {
-	stagedSystemsMap.invoke(Stage::PreUpdate, gameWorld, time, deltaTime);
-	stagedSystemsMap.invoke(Stage::Update, gameWorld, time, deltaTime);
-	stagedSystemsMap.invoke(Stage::LateUpdate, gameWorld, time, deltaTime); }
+void InvokableSystemManager::runStageUpdate(WorldRef gameWorld, float time, float deltaTime) {
+	runStage(Stage::PreUpdate, gameWorld, time, deltaTime);
+	runStage(Stage::Update, gameWorld, time, deltaTime);
+	runStage(Stage::LateUpdate, gameWorld, time, deltaTime); }
 
-void InvokableSystemManager::runStageFixedUpdate(std::shared_ptr<GameWorld> gameWorld, float time, float deltaTime) {
-	stagedSystemsMap.invoke(Stage::FixedUpdate, gameWorld, time, deltaTime);
-	stagedSystemsMap.invoke(Stage::LateFixedUpdate, gameWorld, time, deltaTime); }
+void InvokableSystemManager::runStageFixedUpdate(WorldRef gameWorld, float time, float deltaTime) {
+	runStage(Stage::FixedUpdate, gameWorld, time, deltaTime);
+	runStage(Stage::LateFixedUpdate, gameWorld, time, deltaTime); }
 
-void InvokableSystemManager::runStageDraw(std::shared_ptr<GameWorld> gameWorld) {
-	stagedSystemsMap.invoke(Stage::Draw, gameWorld); }
+void InvokableSystemManager::runStageDraw(WorldRef gameWorld) {
+	runStage(Stage::Draw, gameWorld); }
 
-void InvokableSystemManager::runStageCleanup(std::shared_ptr<GameWorld> gameWorld) {
-	stagedSystemsMap.invoke(Stage::Cleanup, gameWorld); }
+void InvokableSystemManager::runStageCleanup(WorldRef gameWorld) {
+	runStage(Stage::Cleanup, gameWorld); }
 
-void InvokableSystemManager::keyEvent(std::shared_ptr<GameWorld> gameWorld, int key, int action) {
+void InvokableSystemManager::keyEvent(WorldRef gameWorld, int key, int action) {
 	keyboardInputMap.invoke(key, gameWorld, action); }
 
-void InvokableSystemManager::mousePosEvent(std::shared_ptr<GameWorld> gameWorld, double xpos, double ypos) {
+void InvokableSystemManager::mousePosEvent(WorldRef gameWorld, double xpos, double ypos) {
 	otherInputMap.invoke(OtherInput::MOUSE_POS, gameWorld, xpos, ypos); }
 
-void InvokableSystemManager::mouseButtonEvent(std::shared_ptr<GameWorld> gameWorld, int button, int action) {
+void InvokableSystemManager::mouseButtonEvent(WorldRef gameWorld, int button, int action) {
     mouseInputMap.invoke(button, gameWorld, action); }
 
-void InvokableSystemManager::scrollEvent(std::shared_ptr<GameWorld> gameWorld, double distance) {
+void InvokableSystemManager::scrollEvent(WorldRef gameWorld, double distance) {
 	otherInputMap.invoke(OtherInput::SCROLL, gameWorld, distance); }
 
-void InvokableSystemManager::windowResizeEvent(std::shared_ptr<GameWorld> gameWorld, int width, int height) {
+void InvokableSystemManager::windowResizeEvent(WorldRef gameWorld, int width, int height) {
 	otherInputMap.invoke(OtherInput::WINDOW_RESIZE, gameWorld, width, height); }
 
-void InvokableSystemManager::onEntityDestroyed(Entity entity) {
-    for (auto& [event, eventMap] : eventSystemsMap)
-        eventMap.removeEvent(entity);
+void InvokableSystemManager::onEntitiesDestroyed(std::span<const Entity> entities) {
+    for (auto& [event, entityMap] : deliverySystemsMap) {
+        if (entityMap.empty()) continue;
+        for (Entity entity : entities)
+            entityMap.removeEntity(entity);
+    }
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include "systemManager.h"
 #include "../Entity/entity.h"
+#include <span>
 
 namespace Saga {
 
@@ -15,7 +16,7 @@ public:
 	 * @brief Invoke the startup stage. This calls all systems attached in the Awake and Start stages.
 	 * @param gameWorld 
 	 */
-	void runStageStartup(std::shared_ptr<GameWorld> gameWorld);
+	void runStageStartup(WorldRef gameWorld);
 
 	/**
 	 * @brief Invoke the update stage. This calls any PreUpdate, Update, and LateUpdate systems in that order.
@@ -24,7 +25,7 @@ public:
 	 * @param deltaTime the time since the last update.
 	 * @param time total time ellapsed since the start of the program.
 	 */
-	void runStageUpdate(std::shared_ptr<GameWorld> gameWorld, float deltaTime, float time);
+	void runStageUpdate(WorldRef gameWorld, float deltaTime, float time);
 
 	/**
 	 * @brief Invoke the fixed update stage. This calls any FixUpdate, and LateFixedUpdate systems in that order.
@@ -33,21 +34,21 @@ public:
 	 * @param deltaTime the time since the last fixed update.
 	 * @param time total time ellapsed since the start of the program.
 	 */
-	void runStageFixedUpdate(std::shared_ptr<GameWorld> gameWorld, float deltaTime, float time);
+	void runStageFixedUpdate(WorldRef gameWorld, float deltaTime, float time);
 
 	/**
 	 * @brief Invoke the Draw stage.
 	 * 
 	 * @param gameWorld 
 	 */
-	void runStageDraw(std::shared_ptr<GameWorld> gameWorld);
+	void runStageDraw(WorldRef gameWorld);
 
 	/**
 	 * @brief Invoke the Cleanup stage.
 	 * 
 	 * @param gameWorld 
 	 */
-	void runStageCleanup(std::shared_ptr<GameWorld> gameWorld);
+	void runStageCleanup(WorldRef gameWorld);
 
 	/**
 	 * @brief Broadcast an event. Only systems registered that are not tied to a specific entity will receive this broadcast.
@@ -59,9 +60,8 @@ public:
 	 * @param args arguments to be passed to the systems.
 	 */
 	template <typename Event, typename ...DataType>
-	void broadcastEvent(Event event, std::shared_ptr<GameWorld> gameWorld, DataType... args) {
-		if (eventSystemsMap.count((int) event))
-			eventSystemsMap[(int) event].invoke(-1, gameWorld, args...);
+	void broadcastEvent(Event event, WorldRef gameWorld, DataType... args) {
+		broadcastSystemsMap.invoke(event, gameWorld, args...);
 	}
 
 	/**
@@ -75,10 +75,10 @@ public:
 	 * @param args arguments to be passed to the systems attached to this event.
 	 */
 	template <typename Event, typename ...DataType>
-	void deliverEvent(Event event, Entity entity, std::shared_ptr<GameWorld> gameWorld, DataType... args) {
-		if (eventSystemsMap.count((int) event))
-  	        eventSystemsMap[(int) event].invoke(entity,
-                gameWorld, entity, args...);
+	void deliverEvent(Event event, Entity entity, WorldRef gameWorld, DataType... args) {
+		auto it = deliverySystemsMap.find((int) event);
+		if (it != deliverySystemsMap.end())
+			it->second.invoke(entity, gameWorld, entity, args...);
 	}
 
 	/**
@@ -88,7 +88,7 @@ public:
 	 * @param key a GLFW key.
 	 * @param action a GLFW action, like GLFW_PRESSED or GLFW_RELEASE.
 	 */
-    void keyEvent(std::shared_ptr<GameWorld> gameWorld, int key, int action);
+    void keyEvent(WorldRef gameWorld, int key, int action);
 
 	/**
 	 * @brief Broadcast a mouse position event.
@@ -97,7 +97,7 @@ public:
 	 * @param xpos the x position of the mouse in screen space.
 	 * @param ypos the y position of the mouse in screen space.
 	 */
-    void mousePosEvent(std::shared_ptr<GameWorld> gameWorld, double xpos, double ypos);
+    void mousePosEvent(WorldRef gameWorld, double xpos, double ypos);
 
 	/**
 	 * @brief Broadcast a mouse button event.
@@ -106,7 +106,7 @@ public:
 	 * @param key a GLFW key.
 	 * @param action a GLFW action, like GLFW_PRESSED or GLFW_RELEASE.
 	 */
-    void mouseButtonEvent(std::shared_ptr<GameWorld> gameWorld, int button, int action);
+    void mouseButtonEvent(WorldRef gameWorld, int button, int action);
 
 	/**
 	 * @brief Broadcast a scroll event.
@@ -114,7 +114,7 @@ public:
 	 * @param gameWorld 
 	 * @param distance amount of pixels scrolled.
 	 */
-    void scrollEvent(std::shared_ptr<GameWorld> gameWorld, double distance);
+    void scrollEvent(WorldRef gameWorld, double distance);
 
 	/**
 	 * @brief Broadcast a window resize event.
@@ -123,13 +123,27 @@ public:
 	 * @param width the width in pixels of the new window.
 	 * @param height the height in pixels of the new window.
 	 */
-	void windowResizeEvent(std::shared_ptr<GameWorld> gameWorld, int width, int height);
+	void windowResizeEvent(WorldRef gameWorld, int width, int height);
 
     /**
-     * @brief Called when an entity is destroyed.
-     * This disconnects all events that is related to this entity.
+     * @brief Called when entities are destroyed.
+     * This disconnects all events that are related to these entities. Events that no entity listens to are skipped.
+     *
+     * @param entities 
      */
-    void onEntityDestroyed(Entity entity);
+    void onEntitiesDestroyed(std::span<const Entity> entities);
 
+private:
+	/**
+	 * @brief Invoke all systems attached to a stage. Systems run in the order they were added, 
+	 * unless their declared accesses let them run in parallel on the world's JobSystem. Exclusive systems always run on the calling thread.
+	 * 
+	 * @tparam DataType the type of arguments the systems of this stage accept.
+	 * @param stage 
+	 * @param gameWorld 
+	 * @param args arguments to be passed to the systems.
+	 */
+	template <typename ...DataType>
+	void runStage(Stage stage, WorldRef gameWorld, DataType... args);
 };
 }
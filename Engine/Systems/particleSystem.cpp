@@ -15,10 +15,11 @@
 
 namespace Saga::Systems {
 
-void particleSystemSimulationUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
+void particleSystemSimulationUpdate(WorldRef world, float deltaTime, float time) {
     // in the process of simulating the particles, we need
     // to ensure that all and only live particles stay in the index range [left, right)
-    for (Saga::ParticleCollection& collection : *world->viewAll<ParticleCollection>()) {
+    // collections are independent of each other, so they are simulated in parallel
+    world->viewAll<ParticleCollection>()->parallelEach(world->getJobs(), [&](Saga::ParticleCollection& collection) {
         collection.sortByLifetime();
 
         for (int poolIndex = 0; poolIndex < collection.numberOfLiveParticles; poolIndex++) {
@@ -33,38 +34,29 @@ void particleSystemSimulationUpdate(std::shared_ptr<GameWorld> world, float delt
                 break;
             }
         }
-    }
+    });
 }
 
-void particleSystemEmissionUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time) {
-    auto group = *world->viewGroup<Saga::ParticleCollection, Saga::ParticleEmitter, Saga::Transform>();
+void particleSystemEmissionUpdate(WorldRef world, float deltaTime, float time) {
+    auto &group = *world->viewGroup<Saga::ParticleCollection, Saga::ParticleEmitter, Saga::Transform>();
     for (auto [entity, collection, emitter, transform] : group) {
         if (emitter->isPlaying()) {
-            bool hasTranslated = false;
-
             int rawEmissions = (time - emitter->timeLastEmitted) * emitter->emissionRate;
             if (rawEmissions) emitter->timeLastEmitted += rawEmissions * 1.0f / emitter->emissionRate;
 
             int emissionCount = rawEmissions + (emitter->shouldBurst ? emitter->burst : 0);
             
             if (emissionCount) {
-                hasTranslated = true;
-                // here we want to emit at the particle emitter's position. Hence
-                // we are adding the transform position to the particle template
-                // before emitting
-                emitter->particleTemplate.position += transform->getPos();
-
                 // we need to sort the collection so that we know which to override
                 collection->sortByLifetime();
                 collection->resetOverrideElement();
-            }
-
-            while (emissionCount --> 0) collection->emit(emitter->particleTemplate);
 
-            // we undo the add so that the emitter's particleTemplate position
-            // is accurate. If we want to be numerically precise, we could have
-            // cached the position to store back later, but who cares.
-            if (hasTranslated) emitter->particleTemplate.position -= transform->getPos();
+                // here we want to emit at the particle emitter's position in the world,
+                // which may follow a parent. The template itself is left untouched.
+                ParticleTemplate particleTemplate = emitter->particleTemplate;
+                particleTemplate.position += transform->getWorldPos();
+                while (emissionCount --> 0) collection->emit(particleTemplate);
+            }
 
             emitter->shouldBurst = false;
         }
@@ -153,10 +145,12 @@ void particleSystemOnRender(std::shared_ptr<GameWorld> world, Saga::Camera& came
 
 void registerParticleSystem(std::shared_ptr<GameWorld> world) {
     world->registerGroup<Saga::ParticleCollection, Saga::ParticleEmitter, Saga::Transform>();
-    // register the systems
-    world->getSystems().addStagedSystem(Saga::System<float, float>(particleSystemSimulationUpdate),
-                                        SystemManager::Stage::Update);
-    world->getSystems().addStagedSystem(Saga::System<float, float>(particleSystemEmissionUpdate),
-                                        SystemManager::Stage::Update);
+    // register the systems. Both write to the collections, so emission waits for simulation, but either can run alongside other systems.
+    world->getSystems().addStagedSystem(Saga::RefSystem<float, float>(particleSystemSimulationUpdate),
+                                        SystemManager::Stage::Update,
+                                        SystemAccess().write<ParticleCollection>());
+    world->getSystems().addStagedSystem(Saga::RefSystem<float, float>(particleSystemEmissionUpdate),
+                                        SystemManager::Stage::Update,
+                                        SystemAccess().read<Transform>().write<ParticleCollection, ParticleEmitter>());
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Components/camera.h"
+#include "system.h"
 #include <memory>
 
 namespace Saga {
@@ -15,7 +16,7 @@ namespace Saga::Systems {
      * @param deltaTime time since last frame.
      * @param time time ellapsed since the beginnning of the program.
      */
-    void particleSystemSimulationUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+    void particleSystemSimulationUpdate(WorldRef world, float deltaTime, float time);
 
     /**
      * @brief Responsible for emitting new particles according to the world's ParticleEmitter 
@@ -25,7 +26,7 @@ namespace Saga::Systems {
      * @param deltaTime time since last frame.
      * @param time time ellapsed since the beginnning of the program.
      */
-    void particleSystemEmissionUpdate(std::shared_ptr<GameWorld> world, float deltaTime, float time);
+    void particleSystemEmissionUpdate(WorldRef world, float deltaTime, float time);
 
     /**
      * @brief Responsible for rendering particle systems on screen.
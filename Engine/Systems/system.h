@@ -5,6 +5,30 @@
 namespace Saga {
 	class GameWorld;
 
+	/**
+	 * @brief A non-owning handle to a GameWorld, used by RefSystem. It is a plain pointer, so passing it around costs nothing,
+	 * unlike a shared_ptr whose reference count has to be updated atomically on every copy.
+	 * The world must outlive the handle, which always holds for the duration of a System call.
+	 */
+	class WorldRef {
+	public:
+		WorldRef(GameWorld& world) : world(&world) {}
+		WorldRef(const std::shared_ptr<GameWorld>& world) : world(world.get()) {}
+
+		GameWorld* operator->() const { return world; }
+		GameWorld& operator*() const { return *world; }
+		GameWorld* get() const { return world; }
+
+		/**
+		 * @brief Get an owning pointer to the world, for code that still expects one.
+		 * 
+		 * @return std::shared_ptr<GameWorld> 
+		 */
+		std::shared_ptr<GameWorld> shared() const;
+	private:
+		GameWorld* world;
+	};
+
 	/**
 	 * @brief System is a function that accepts a shared_ptr to a GameWorld, as well as extra variables.
 	 * 
@@ -12,4 +36,13 @@ namespace Saga {
 	 */
 	template <typename ...DataType>
 	using System = std::function<void(std::shared_ptr<GameWorld>, DataType...)>;
+
+	/**
+	 * @brief A System that accepts a WorldRef instead of a shared_ptr. Prefer this for Systems that run often, 
+	 * since calling it does not touch any reference count.
+	 * 
+	 * @tparam DataType the types of extra variables that a system accept
+	 */
+	template <typename ...DataType>
+	using RefSystem = std::function<void(WorldRef, DataType...)>;
 }
@@ -0,0 +1,15 @@
+#include "systemAccess.h"
+
+namespace Saga {
+
+bool SystemAccess::conflictsWith(const SystemAccess& other) const {
+	if (exclusive || other.exclusive) return true;
+	return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any()
+		|| (resourceWrites & (other.resourceReads | other.resourceWrites)).any() || (other.resourceWrites & resourceReads).any();
+}
+
+void SystemAccess::ensureContainers(GameWorld& world) const {
+	for (auto ensure : ensurers) ensure(world);
+}
+
+} // namespace Saga
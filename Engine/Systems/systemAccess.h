@@ -0,0 +1,155 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "../Datastructures/typemap.h"
+#include "../_Core/asserts.h"
+#include "../Gameworld/signature.h"
+
+namespace Saga {
+
+class GameWorld;
+class IComponentContainer;
+
+/**
+ * @brief Declares which components a System reads and which it writes, so that Systems that do not conflict can run at the same time.
+ * Two Systems conflict if one of them writes a component the other reads or writes.
+ * 
+ * A default constructed SystemAccess declares nothing, and is treated as exclusive: the System conflicts with every other System in its stage.
+ * Once read() or write() is called, the System is only allowed to touch the declared components, 
+ * and must record structural changes (creating entities, emplacing or removing components) through the world's CommandBuffer.
+ * A System that touches no components can declare so with read<>().
+ * Resources of the world (see GameWorld::resource()) are declared separately, with readResource() and writeResource().
+ */
+class SystemAccess {
+public:
+	/**
+	 * @brief Declare components the System reads.
+	 * 
+	 * @tparam Component the components.
+	 * @return SystemAccess& this, so that declarations can be chained.
+	 */
+	template <typename... Component>
+	SystemAccess& read();
+
+	/**
+	 * @brief Declare components the System writes. Writing implies reading.
+	 * 
+	 * @tparam Component the components.
+	 * @return SystemAccess& this, so that declarations can be chained.
+	 */
+	template <typename... Component>
+	SystemAccess& write();
+
+	/**
+	 * @brief Declare resources of the world the System reads.
+	 * Unlike components, resources are not created on declaration: they are set up before the Systems run.
+	 * 
+	 * @tparam Resource the resources.
+	 * @return SystemAccess& this, so that declarations can be chained.
+	 */
+	template <typename... Resource>
+	SystemAccess& readResource();
+
+	/**
+	 * @brief Declare resources of the world the System writes. Writing implies reading.
+	 * 
+	 * @tparam Resource the resources.
+	 * @return SystemAccess& this, so that declarations can be chained.
+	 */
+	template <typename... Resource>
+	SystemAccess& writeResource();
+
+	/**
+	 * @return true if nothing was declared, so the System must run alone.
+	 * @return false otherwise.
+	 */
+	bool isExclusive() const { return exclusive; }
+
+	/**
+	 * @brief Determine if two Systems cannot run at the same time.
+	 * 
+	 * @param other 
+	 * @return true if either is exclusive, or if one writes a component or resource the other accesses.
+	 * @return false otherwise.
+	 */
+	bool conflictsWith(const SystemAccess& other) const;
+
+	/**
+	 * @brief Make sure every declared component has a container in the world. Containers are created lazily on first access,
+	 * which cannot be allowed to happen while other Systems are running.
+	 * 
+	 * @param world 
+	 */
+	void ensureContainers(GameWorld& world) const;
+private:
+	bool exclusive = true;
+	Signature reads; //!< components that are read but not written.
+	Signature writes; //!< components that are written.
+	Signature resourceReads; //!< resources that are read but not written, indexed by resource id.
+	Signature resourceWrites; //!< resources that are written, indexed by resource id.
+	std::vector<void(*)(GameWorld&)> ensurers; //!< for each declared component, a function creating its container.
+
+	/**
+	 * @brief Create the container of a component in the world, if it does not exist yet.
+	 * 
+	 * @tparam Component 
+	 * @param world 
+	 */
+	template <typename Component>
+	static void ensureContainer(GameWorld& world);
+
+	/**
+	 * @tparam Component 
+	 * @return int the id of the component, the same as GameWorld::getTypeId().
+	 */
+	template <typename Component>
+	static int getComponentId() { return TypeMap<std::shared_ptr<IComponentContainer>>::getTypeId<Component>(); }
+
+	/**
+	 * @tparam Resource 
+	 * @return int the id of the resource, the same as GameWorld::getResourceId().
+	 */
+	template <typename Resource>
+	static int getResourceId() {
+		int id = TypeMap<std::shared_ptr<void>>::getTypeId<Resource>();
+		SASSERT_MESSAGE(id < MAX_COMPONENTS, "Too many resource types have been declared by Systems. Consider increasing MAX_COMPONENTS in signature.h.");
+		return id;
+	}
+};
+
+template <typename... Component>
+SystemAccess& SystemAccess::read() {
+	exclusive = false;
+	([&] {
+		reads[getComponentId<Component>()] = true;
+		ensurers.push_back(&ensureContainer<Component>);
+	}(), ...);
+	return *this;
+}
+
+template <typename... Component>
+SystemAccess& SystemAccess::write() {
+	exclusive = false;
+	([&] {
+		writes[getComponentId<Component>()] = true;
+		ensurers.push_back(&ensureContainer<Component>);
+	}(), ...);
+	return *this;
+}
+
+template <typename... Resource>
+SystemAccess& SystemAccess::readResource() {
+	exclusive = false;
+	(resourceReads.set(getResourceId<Resource>()), ...);
+	return *this;
+}
+
+template <typename... Resource>
+SystemAccess& SystemAccess::writeResource() {
+	exclusive = false;
+	(resourceWrites.set(getResourceId<Resource>()), ...);
+	return *this;
+}
+
+} // namespace Saga
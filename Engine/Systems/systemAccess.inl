@@ -0,0 +1,13 @@
+#pragma once
+
+#include "systemAccess.h"
+#include "../Gameworld/gameworld.h"
+
+namespace Saga {
+
+template <typename Component>
+void SystemAccess::ensureContainer(GameWorld& world) {
+	world.viewAll<Component>();
+}
+
+} // namespace Saga
@@ -1,35 +1,85 @@
 #include "systemManager.h"
+#include <algorithm>
 
 namespace Saga {
 
-SystemManager::SystemManager() {}
+SystemManager::SystemManager() : stageSchedules((int) Stage::Cleanup + 1) {}
 SystemManager::~SystemManager() {}
 
 void SystemManager::removeStagedSystem(EventMap::Id id, Stage stage) {
-	stagedSystemsMap.removeListener(stage, id); }
+	StageSchedule& schedule = stageSchedules[(int) stage];
+	auto it = std::find_if(schedule.systems.begin(), schedule.systems.end(), [id](const StagedSystem& system) { return system.id == id; });
+	if (it == schedule.systems.end()) {
+		SWARN("Trying to remove staged system %d from stage %d, but the stage does not have this system.", id, stage);
+		return;
+	}
+	schedule.systems.erase(it);
+	schedule.dirty = true;
+}
+
+SystemManager::StageSchedule& SystemManager::getSchedule(Stage stage) {
+	StageSchedule& schedule = stageSchedules[(int) stage];
+	if (!schedule.dirty) return schedule;
+
+	schedule.batches.clear();
+	std::uint32_t n = schedule.systems.size();
+	for (std::uint32_t begin = 0, end; begin < n; begin = end) {
+		// exclusive systems get a batch of their own. Otherwise, take every declared system up to the next exclusive one.
+		end = begin + 1;
+		if (!schedule.systems[begin].access.isExclusive())
+			while (end < n && !schedule.systems[end].access.isExclusive()) end++;
+
+		// a system has to wait for every earlier system it conflicts with, which keeps the order they were added in where it matters
+		StageBatch& batch = schedule.batches.emplace_back();
+		batch.begin = begin;
+		batch.end = end;
+		batch.dependencies.assign(end - begin, {});
+		bool chained = true;
+		for (std::uint32_t i = 0; i < end - begin; i++) {
+			for (std::uint32_t j = 0; j < i; j++)
+				if (schedule.systems[begin + i].access.conflictsWith(schedule.systems[begin + j].access)) 
+					batch.dependencies[i].push_back(j);
+			// if every system depends on the one before, there is nothing to run in parallel
+			if (i && (batch.dependencies[i].empty() || batch.dependencies[i].back() != i - 1)) chained = false;
+		}
+		batch.parallel = !chained;
+	}
+	schedule.dirty = false;
+	return schedule;
+}
 
 EventMap::Id SystemManager::addKeyboardEventSystem(int key, System<int> system) {
-	return keyboardInputMap.addListener(key, std::make_shared<System<int>>(system)); }
+	return addKeyboardEventSystem(key, toRefSystem(std::move(system))); }
+EventMap::Id SystemManager::addKeyboardEventSystem(int key, RefSystem<int> system) {
+	return keyboardInputMap.addListener(key, std::move(system)); }
 void SystemManager::removeKeyboardEventSystem(int key, EventMap::Id id) {
 	keyboardInputMap.removeListener(key, id); }
 
-EventMap::Id SystemManager::addMouseEventSystem(int key, System<int> system) { 
-	return mouseInputMap.addListener(key, std::make_shared<System<int>>(system)); }
+EventMap::Id SystemManager::addMouseEventSystem(int key, System<int> system) {
+	return addMouseEventSystem(key, toRefSystem(std::move(system))); }
+EventMap::Id SystemManager::addMouseEventSystem(int key, RefSystem<int> system) {
+	return mouseInputMap.addListener(key, std::move(system)); }
 void SystemManager::removeMouseEventSystem(int key, EventMap::Id id) {
 	mouseInputMap.removeListener(key, id); }
 
 EventMap::Id SystemManager::addMousePosSystem(System<double, double> system) {
-    return otherInputMap.addListener(OtherInput::MOUSE_POS, std::make_shared<System<double,double>>(system)); }
+	return addMousePosSystem(toRefSystem(std::move(system))); }
+EventMap::Id SystemManager::addMousePosSystem(RefSystem<double, double> system) {
+	return otherInputMap.addListener(OtherInput::MOUSE_POS, std::move(system)); }
 void SystemManager::removeMousePosSystem(EventMap::Id id) {
 	otherInputMap.removeListener(OtherInput::MOUSE_POS, id); }
 
 EventMap::Id SystemManager::addScrollSystem(System<double> system) {
-    return otherInputMap.addListener(OtherInput::SCROLL, std::make_shared<System<double>>(system)); }
+	return addScrollSystem(toRefSystem(std::move(system))); }
+EventMap::Id SystemManager::addScrollSystem(RefSystem<double> system) {
+	return otherInputMap.addListener(OtherInput::SCROLL, std::move(system)); }
 void SystemManager::removeScrollSystem(EventMap::Id id) {
 	otherInputMap.removeListener(OtherInput::SCROLL, id); }
 
 EventMap::Id SystemManager::addWindowResizeSystem(System<int, int> system) {
-    return otherInputMap.addListener(OtherInput::WINDOW_RESIZE, std::make_shared<System<int,int>>(system)); }
+	return addWindowResizeSystem(toRefSystem(std::move(system))); }
+EventMap::Id SystemManager::addWindowResizeSystem(RefSystem<int, int> system) {
+	return otherInputMap.addListener(OtherInput::WINDOW_RESIZE, std::move(system)); }
 void SystemManager::removeWindowResizeSystem(EventMap::Id id) {
 	otherInputMap.removeListener(OtherInput::WINDOW_RESIZE, id); }
 
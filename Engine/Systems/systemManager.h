@@ -5,8 +5,10 @@
 #include <functional>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include "../Datastructures/eventmap.h"
 #include "../Entity/entity.h"
+#include "systemAccess.h"
 
 namespace Saga {
 
@@ -46,14 +48,28 @@ public:
 
 	/**
 	 * @brief Add a staged System to the list of systems.
+	 * Systems in the same stage run in the order they were added, except that Systems whose declared accesses do not conflict may run at the same time.
 	 * 
 	 * @tparam DataType the data types that the System accepts. 
 	 * @param system 
 	 * @param stage which stage is the System attached to. When this stage is invoked, all systems attached to the stage is invoked.
+	 * @param access the components the System reads and writes. If nothing is declared, the System runs alone.
 	 * @return EventMap::Id id of the System, can be used to remove the system later.
 	 */
 	template <typename ...DataType>
-	EventMap::Id addStagedSystem(System<DataType...> system, Stage stage = Stage::Update);
+	EventMap::Id addStagedSystem(System<DataType...> system, Stage stage = Stage::Update, SystemAccess access = SystemAccess());
+
+	/**
+	 * @brief Add a staged RefSystem to the list of systems. Same as above, but the System receives a WorldRef.
+	 * 
+	 * @tparam DataType the data types that the System accepts. 
+	 * @param system 
+	 * @param stage which stage is the System attached to.
+	 * @param access the components the System reads and writes. If nothing is declared, the System runs alone.
+	 * @return EventMap::Id id of the System, can be used to remove the system later.
+	 */
+	template <typename ...DataType>
+	EventMap::Id addStagedSystem(RefSystem<DataType...> system, Stage stage = Stage::Update, SystemAccess access = SystemAccess());
 
 	/**
 	 * @brief Remove a staged System.
@@ -78,6 +94,18 @@ public:
 	template <typename Event, typename ...DataType>
 	EventMap::Id addEventSystem(Event event, System<DataType...> system);
 
+	/**
+	 * @brief Add an event RefSystem. Same as above, but the System receives a WorldRef.
+	 * 
+	 * @tparam Event could be anything castable to an integer.
+	 * @tparam DataType the data types that the Systems that receive these events accept.
+	 * @param event the event.
+	 * @param system the System to add.
+	 * @return EventMap::Id id of the System, can be used to remove the system later
+	 */
+	template <typename Event, typename ...DataType>
+	EventMap::Id addEventSystem(Event event, RefSystem<DataType...> system);
+
 	/**
 	 * @brief Remove the System from being called when an event is broadcasted.
 	 * 
@@ -102,6 +130,19 @@ public:
 	template <typename Event, typename ...DataType>
 	EventMap::Id addEventSystem(Event event, Saga::Entity entity, System<Saga::Entity, DataType...> system);
 
+	/**
+	 * @brief Add an event RefSystem specific to an entity. Same as above, but the System receives a WorldRef.
+	 * 
+	 * @tparam Event can be anything castable to an integer.
+	 * @tparam DataType the data type the System accepts as argument.
+	 * @param event 
+	 * @param entity 
+	 * @param system 
+	 * @return EventMap::Id id of the System, can be used to remove it later.
+	 */
+	template <typename Event, typename ...DataType>
+	EventMap::Id addEventSystem(Event event, Saga::Entity entity, RefSystem<Saga::Entity, DataType...> system);
+
 	/**
 	 * @brief Remove the System from being called when an event is delivered.
 	 * 
@@ -121,6 +162,7 @@ public:
 	 * @return EventMap::Id id of the event, can be used to remove it later.
 	 */
 	EventMap::Id addKeyboardEventSystem(int key, System<int> system);
+	EventMap::Id addKeyboardEventSystem(int key, RefSystem<int> system); //!< same as above, but the System receives a WorldRef.
 
 	/**
 	 * @brief Remove a keyboard System.
@@ -138,6 +180,7 @@ public:
 	 * @return EventMap::Id 
 	 */
 	EventMap::Id addMouseEventSystem(int key, System<int> system);
+	EventMap::Id addMouseEventSystem(int key, RefSystem<int> system); //!< same as above, but the System receives a WorldRef.
 
 	/**
 	 * @brief Remove a System from responding to mouse button inputs.
@@ -154,6 +197,7 @@ public:
 	 * @return EventMap::Id 
 	 */
 	EventMap::Id addMousePosSystem(System<double, double> system);
+	EventMap::Id addMousePosSystem(RefSystem<double, double> system); //!< same as above, but the System receives a WorldRef.
 	void removeMousePosSystem(EventMap::Id id);
 
 	/**
@@ -163,6 +207,7 @@ public:
 	 * @return EventMap::Id 
 	 */
 	EventMap::Id addScrollSystem(System<double> system);
+	EventMap::Id addScrollSystem(RefSystem<double> system); //!< same as above, but the System receives a WorldRef.
 	void removeScrollSystem(EventMap::Id id);
 
 	/**
@@ -172,6 +217,7 @@ public:
 	 * @return EventMap::Id 
 	 */
 	EventMap::Id addWindowResizeSystem(System<int, int> system);
+	EventMap::Id addWindowResizeSystem(RefSystem<int, int> system); //!< same as above, but the System receives a WorldRef.
 
 	/**
 	 * @brief Remove a resize System.
@@ -190,21 +236,74 @@ protected:
 		SCROLL,
 		WINDOW_RESIZE
 	};
+	/**
+	 * @brief Wrap a System into a RefSystem. Calling the wrapper has to retrieve a shared_ptr to the world, 
+	 * so only Systems written against the old signature pay for it.
+	 * 
+	 * @tparam DataType 
+	 * @param system 
+	 * @return RefSystem<DataType...> 
+	 */
+	template <typename ...DataType>
+	static RefSystem<DataType...> toRefSystem(System<DataType...> system);
+
 	static auto id_value()
-		-> uint64_t & {
-		static uint64_t the_id;
+		-> std::atomic<uint64_t> & {
+		static std::atomic<uint64_t> the_id(0);
 		return the_id;
 	}
 
 	/**
-	 * @brief Map between Stage and Systems
+	 * @brief A System attached to a stage.
+	 */
+	struct StagedSystem {
+		EventMap::Id id;
+		std::unique_ptr<ICallback> callback; //!< a Callback accepting a WorldRef or a shared_ptr to the world, and the arguments of the stage.
+		SystemAccess access;
+	};
+
+	/**
+	 * @brief A run of consecutive Systems in a stage, along with the order they have to respect. 
+	 * An exclusive System always sits in a batch of its own, and so acts as a barrier between the batches around it.
+	 */
+	struct StageBatch {
+		std::uint32_t begin; //!< index of the first system of the batch.
+		std::uint32_t end; //!< index past the last system of the batch.
+		std::vector<std::vector<std::uint32_t>> dependencies; //!< dependencies[i] lists the earlier systems of the batch that system begin+i conflicts with, relative to begin.
+		bool parallel = false; //!< whether any two systems of the batch may run at the same time. If not, systems simply run one after another.
+	};
+
+	/**
+	 * @brief All Systems attached to a stage, split into batches.
+	 */
+	struct StageSchedule {
+		std::vector<StagedSystem> systems; //!< in the order they were added.
+		std::vector<StageBatch> batches; //!< covers systems, in order.
+		bool dirty = false; //!< whether systems were added or removed since the batches were computed.
+	};
+
+	/**
+	 * @brief Schedule of each Stage, indexed by the Stage.
+	 */
+	std::vector<StageSchedule> stageSchedules;
+
+	/**
+	 * @brief Get the schedule of a stage, recomputing its batches if its systems changed.
+	 * 
+	 * @param stage 
+	 * @return StageSchedule& 
+	 */
+	StageSchedule& getSchedule(Stage stage);
+
+	/**
+	 * @brief Maps Event to the Systems listening to its broadcasts.
 	 */
-	EventMap stagedSystemsMap;
+	EventMap broadcastSystemsMap;
 
 	/**
-	 * @brief Maps entity to an EventMap that maps Event to System
+	 * @brief Maps Event to the Systems attached to each entity, for deliveries.
 	 */
-	std::unordered_map<int, EventMap> eventSystemsMap;
+	std::unordered_map<int, EntityEventMap> deliverySystemsMap;
 
 	// input maps
 	EventMap keyboardInputMap;
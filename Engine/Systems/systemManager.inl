@@ -5,38 +5,65 @@
 
 namespace Saga {
 	template <typename ...DataType>
-    EventMap::Id SystemManager::addStagedSystem(System<DataType...> system, Stage stage) {
-        return stagedSystemsMap.addListener(stage, std::make_shared<System<DataType...>>(system)); }
+	RefSystem<DataType...> SystemManager::toRefSystem(System<DataType...> system) {
+		return [system = std::move(system)](WorldRef world, DataType... args) { system(world.shared(), args...); };
+	}
+
+	template <typename ...DataType>
+    EventMap::Id SystemManager::addStagedSystem(System<DataType...> system, Stage stage, SystemAccess access) {
+		// kept as is, since the stage can hand the same shared_ptr to all such Systems
+		const EventMap::Id id = EventMap::Id(++id_value());
+		StageSchedule& schedule = stageSchedules[(int) stage];
+		schedule.systems.push_back({id, std::make_unique<Callback<std::shared_ptr<GameWorld>, DataType...>>(std::move(system)), access});
+		schedule.dirty = true;
+		return id;
+	}
+
+	template <typename ...DataType>
+    EventMap::Id SystemManager::addStagedSystem(RefSystem<DataType...> system, Stage stage, SystemAccess access) {
+		const EventMap::Id id = EventMap::Id(++id_value());
+		StageSchedule& schedule = stageSchedules[(int) stage];
+		schedule.systems.push_back({id, std::make_unique<Callback<WorldRef, DataType...>>(std::move(system)), access});
+		schedule.dirty = true;
+		return id;
+	}
 
 	template <typename Event, typename ...DataType>
 	EventMap::Id SystemManager::addEventSystem(Event event, System<DataType...> system) {
-        return eventSystemsMap[(int) event].addListener((Entity) -1, std::make_shared<System<DataType...>>(system)); // ensures no message events gets triggered
+        return addEventSystem(event, toRefSystem(std::move(system)));
+	}
+
+	template <typename Event, typename ...DataType>
+	EventMap::Id SystemManager::addEventSystem(Event event, RefSystem<DataType...> system) {
+        return broadcastSystemsMap.addListener(event, std::move(system));
 	}
 
 	template <typename Event>
 	void SystemManager::removeEventSystem(Event event, EventMap::Id id) {
-		int ev = (int) event;
-		if (!eventSystemsMap.count(ev)) {
-			SWARN("Attempt to remove a broadcast-type event system from event %s, which does not exist.", event);
-			return;
-		}
-		eventSystemsMap[ev].removeListener((Entity) -1, id); 
+		broadcastSystemsMap.removeListener(event, id);
 	}
 
 	
 	template <typename Event, typename ...DataType>
 	EventMap::Id SystemManager::addEventSystem(Event event, Saga::Entity entity, 
             System<Saga::Entity, DataType...> system) {
-		return eventSystemsMap[(int) event].addListener(entity, std::make_shared<System<Saga::Entity, DataType...>>(system));
+		return addEventSystem(event, entity, toRefSystem(std::move(system)));
+	}
+
+	template <typename Event, typename ...DataType>
+	EventMap::Id SystemManager::addEventSystem(Event event, Saga::Entity entity, 
+            RefSystem<Saga::Entity, DataType...> system) {
+		return deliverySystemsMap[(int) event].addListener(entity, std::move(system));
 	}
 
 	template <typename Event>
 	void SystemManager::removeEventSystem(Event event, Saga::Entity entity, EventMap::Id id) {
 		int ev = (int) event;
-		if (!eventSystemsMap.count(ev)) {
-			SWARN("Attempt to remove a delivery-type event system from event %s, which does not exist.", event);
+		auto it = deliverySystemsMap.find(ev);
+		if (it == deliverySystemsMap.end()) {
+			SWARN("Attempt to remove a delivery-type event system from event %d, which does not exist.", ev);
 			return;
 		}
-		eventSystemsMap[ev].removeListener(entity, id);
+		it->second.removeListener(entity, id);
 	}
 }
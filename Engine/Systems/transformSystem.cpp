@@ -0,0 +1,25 @@
+#include "transformSystem.h"
+#include "Engine/Components/hierarchy.h"
+#include "Engine/Components/transform.h"
+#include "Engine/MetaSystems/hierarchy.h"
+#include "Engine/Gameworld/gameworld.h"
+
+namespace Saga::Systems {
+
+void transformSystem(std::shared_ptr<GameWorld> world) {
+    // transforms without a parent only depend on themselves
+    world->viewAll<Transform>()->parallelEach(world->getJobs(), [](Transform& transform) {
+        if (transform.isDirty() && !transform.isAttached()) transform.updateModelMatrix();
+    });
+    // attached ones follow their parents, in a single breadth-first pass
+    Hierarchy::propagate(world);
+}
+
+void registerTransformSystem(std::shared_ptr<GameWorld> world) {
+    // created up front, as the system may run alongside others
+    world->resource<TransformHierarchy>();
+    world->getSystems().addStagedSystem(Saga::System<>(Saga::Systems::transformSystem), Saga::SystemManager::Stage::Draw, 
+        Saga::SystemAccess().write<Transform, Children>().read<Parent>());
+}
+
+} // namespace Saga::Systems
@@ -0,0 +1,26 @@
+#pragma once
+#include <memory>
+
+namespace Saga {
+    class GameWorld;
+}
+
+namespace Saga::Systems {
+    /**
+     * @brief Rebuilds the model matrix of every Transform that changed since it was last built.
+     * This walks the Transform container linearly, in parallel, then propagates world matrices down the hierarchy 
+     * (see Saga::Hierarchy), so that the draw passes and physics only read cached matrices afterwards.
+     *
+     * @ingroup system
+     * @param world
+     */
+    void transformSystem(std::shared_ptr<GameWorld> world);
+
+    /**
+     * @brief Register the transformSystem as a Draw staged system. Systems registered after it in the Draw stage
+     * that touch Transform run after it.
+     *
+     * @param world
+     */
+    void registerTransformSystem(std::shared_ptr<GameWorld> world);
+}
@@ -2,6 +2,7 @@
 
 #include "app.h"
 #include "core.h"
+#include "jobSystem.h"
 #include "window.h"
 #include "logger.h"
 #include "asserts.h"
\ No newline at end of file
@@ -6,7 +6,7 @@
 using namespace std;
 
 namespace Saga {
-App::App() {
+App::App() : jobs(std::make_shared<JobSystem>()) {
 }
 
 App::~App() {
@@ -76,6 +76,7 @@ void App::windowResizeEvent(int width, int height) {
 
 std::shared_ptr<GameWorld> App::createGameWorld() {
     std::shared_ptr<GameWorld> world = worlds.emplace_back(std::make_shared<AppExclusiveGameWorld>());
+	world->setJobs(jobs);
 
 	Physics::registerPhysicsMetaSystem(world);
 
@@ -87,46 +88,47 @@ void App::removeGameWorld(std::shared_ptr<GameWorld> world) {
 }
 
 void App::AppExclusiveGameWorld::runStageStartup() {
-	systemManager.runStageStartup(shared_from_this()); 
+	systemManager.runStageStartup(*this); 
     entityCleanup();
 }
 
 void App::AppExclusiveGameWorld::runStageUpdate(float deltaTime, float time) {
-	systemManager.runStageUpdate(shared_from_this(), deltaTime, time);
+	systemManager.runStageUpdate(*this, deltaTime, time);
     entityCleanup();
+    endFrame();
 }
 
 void App::AppExclusiveGameWorld::runStageFixedUpdate(float deltaTime, float time) {
-	systemManager.runStageFixedUpdate(shared_from_this(), deltaTime, time);
+	systemManager.runStageFixedUpdate(*this, deltaTime, time);
     entityCleanup();
 }
 
 void App::AppExclusiveGameWorld::runStageDraw() {
-	systemManager.runStageDraw(shared_from_this());
+	systemManager.runStageDraw(*this);
 }
 
 void App::AppExclusiveGameWorld::runStageCleanup() {
-	systemManager.runStageCleanup(shared_from_this());
+	systemManager.runStageCleanup(*this);
 }
 
 void App::AppExclusiveGameWorld::keyEvent(int key, int action) {
-	systemManager.keyEvent(shared_from_this(), key, action);
+	systemManager.keyEvent(*this, key, action);
 }
 
 void App::AppExclusiveGameWorld::mousePosEvent(double xpos, double ypos) {
-	systemManager.mousePosEvent(shared_from_this(), xpos, ypos);
+	systemManager.mousePosEvent(*this, xpos, ypos);
 }
 
 void App::AppExclusiveGameWorld::mouseButtonEvent(int button, int action) {
-	systemManager.mouseButtonEvent(shared_from_this(), button, action);
+	systemManager.mouseButtonEvent(*this, button, action);
 }
 
 void App::AppExclusiveGameWorld::scrollEvent(double distance) {
-	systemManager.scrollEvent(shared_from_this(), distance);
+	systemManager.scrollEvent(*this, distance);
 }
 
 void App::AppExclusiveGameWorld::windowResizeEvent(int width, int height) {
-	systemManager.windowResizeEvent(shared_from_this(), width, height);
+	systemManager.windowResizeEvent(*this, width, height);
 }
 
 
@@ -3,6 +3,7 @@
 #include <vector>
 #include <utility>
 #include "../Gameworld/gameworld.h"
+#include "jobSystem.h"
 
 namespace Saga {
 
@@ -98,6 +99,13 @@ public:
 	 */
 	void removeGameWorld(std::shared_ptr<GameWorld> world);
 
+	/**
+	 * @brief Get the JobSystem shared by every GameWorld of this App.
+	 * 
+	 * @return JobSystem& 
+	 */
+	JobSystem& getJobs() { return *jobs; }
+
 private:
 	/**
 	 * @brief Used so that only App has exclusive right to invoke Staged Systems and Input Systems.
@@ -118,6 +126,7 @@ private:
 		void scrollEvent(double distance);
 		void windowResizeEvent(int width, int height);
 	};
+	std::shared_ptr<JobSystem> jobs; //!< worker threads shared by all worlds.
 	std::vector<std::shared_ptr<AppExclusiveGameWorld>> worlds;
 };
 }
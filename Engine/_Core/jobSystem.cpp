@@ -0,0 +1,139 @@
+#include "jobSystem.h"
+#include <algorithm>
+
+namespace Saga {
+
+namespace {
+	// lets a thread find its own queue. Threads outside of any pool have no owner.
+	thread_local const JobSystem* currentOwner = nullptr;
+	thread_local std::size_t currentIndex = 0;
+}
+
+JobSystem::JobSystem(unsigned int workerCnt) {
+	for (unsigned int i = 0; i <= workerCnt; i++)
+		queues.push_back(std::make_unique<Queue>());
+	for (unsigned int i = 0; i < workerCnt; i++)
+		workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers) worker.join();
+}
+
+unsigned int JobSystem::defaultWorkerCnt() {
+	// hardware_concurrency can report 0 when it does not know
+	return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+JobHandle JobSystem::schedule(std::function<void()> work) {
+	JobHandle job = std::make_shared<Job>();
+	job->work = std::move(work);
+	enqueue(job);
+	return job;
+}
+
+JobHandle JobSystem::schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies) {
+	JobHandle job = std::make_shared<Job>();
+	job->work = std::move(work);
+
+	// the extra count keeps the job from being queued while dependencies are still being registered
+	job->pendingDependencies = dependencies.size() + 1;
+	for (const JobHandle& dependency : dependencies) {
+		if (dependency) {
+			std::lock_guard<std::mutex> lock(dependency->mutex);
+			if (!dependency->finished) {
+				dependency->continuations.push_back(job);
+				continue;
+			}
+		}
+		job->pendingDependencies--;
+	}
+	if (!--job->pendingDependencies) enqueue(job);
+	return job;
+}
+
+void JobSystem::wait(const JobHandle& job) {
+	while (!job->isDone()) 
+		if (!runOne()) std::this_thread::yield();
+}
+
+void JobSystem::enqueue(JobHandle job) {
+	Queue& queue = *queues[getQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(std::move(job));
+	}
+	queued++;
+	// taking the lock makes sure a worker about to sleep sees the new job
+	{ std::lock_guard<std::mutex> lock(sleepMutex); }
+	wake.notify_one();
+}
+
+bool JobSystem::runOne() {
+	std::size_t own = getQueueIndex();
+	JobHandle job;
+
+	// newest job of our own queue first, as its data is most likely still in cache
+	{
+		Queue& queue = *queues[own];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+		}
+	}
+
+	// otherwise steal the oldest job of someone else
+	for (std::size_t i = 1; !job && i < queues.size(); i++) {
+		Queue& queue = *queues[(own + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty()) {
+			job = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+		}
+	}
+
+	if (!job) return false;
+	queued--;
+	execute(job);
+	return true;
+}
+
+void JobSystem::execute(const JobHandle& job) {
+	job->work();
+	// release whatever the work captured
+	job->work = nullptr;
+
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->finished = true;
+		continuations.swap(job->continuations);
+	}
+	job->done.store(true, std::memory_order_release);
+
+	for (JobHandle& continuation : continuations)
+		if (!--continuation->pendingDependencies) enqueue(std::move(continuation));
+}
+
+std::size_t JobSystem::getQueueIndex() const {
+	// threads outside of the pool share the last queue
+	return currentOwner == this ? currentIndex : queues.size() - 1;
+}
+
+void JobSystem::workerLoop(std::size_t index) {
+	currentOwner = this;
+	currentIndex = index;
+	while (!stopping) {
+		if (runOne()) continue;
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		wake.wait(lock, [this] { return stopping || queued > 0; });
+	}
+}
+
+} // namespace Saga
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Saga {
+
+const std::size_t CACHE_LINE_SIZE = 64; //!< size in bytes of a cache line, for splitting work so that threads do not share lines.
+
+/**
+ * @brief A unit of work scheduled on a JobSystem.
+ */
+class Job {
+public:
+	/**
+	 * @return true if the job has finished running.
+	 * @return false otherwise.
+	 */
+	bool isDone() const { return done.load(std::memory_order_acquire); }
+private:
+	friend class JobSystem;
+
+	std::function<void()> work;
+	std::atomic<std::uint32_t> pendingDependencies = 0; //!< jobs that have to finish before this one can be queued.
+	std::atomic<bool> done = false;
+
+	std::mutex mutex; //!< guards finished and continuations.
+	bool finished = false;
+	std::vector<std::shared_ptr<Job>> continuations; //!< jobs waiting on this one.
+};
+
+/**
+ * @brief Handle to a scheduled Job. Can be waited on, or used as a dependency of other jobs.
+ */
+using JobHandle = std::shared_ptr<Job>;
+
+/**
+ * @brief A work-stealing pool of worker threads. 
+ * Each worker has its own queue of jobs: it takes from the back of its own queue, and when it runs out, steals from the front of others'.
+ * Jobs scheduled from threads outside the pool, like the main thread, go to a queue of their own that workers also steal from.
+ * Threads waiting on a job help by running other jobs instead of blocking.
+ * 
+ * The JobSystem does not depend on a window or a GameWorld, so it can be used headless.
+ */
+class JobSystem {
+public:
+	/**
+	 * @brief Construct a new Job System, and start its workers.
+	 * 
+	 * @param workerCnt number of worker threads. Defaults to one less than the number of hardware threads, since the main thread helps while waiting.
+	 */
+	JobSystem(unsigned int workerCnt = defaultWorkerCnt());
+
+	/**
+	 * @brief Stop and join all workers. Jobs that have not started yet are dropped.
+	 */
+	~JobSystem();
+
+	/**
+	 * @brief Schedule a job.
+	 * 
+	 * @param work the work to run.
+	 * @return JobHandle 
+	 */
+	JobHandle schedule(std::function<void()> work);
+
+	/**
+	 * @brief Schedule a continuation, which is only queued once all its dependencies have finished.
+	 * 
+	 * @param work the work to run.
+	 * @param dependencies jobs that have to finish first. Finished or null jobs are ignored.
+	 * @return JobHandle 
+	 */
+	JobHandle schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies);
+
+	/**
+	 * @brief Wait for a job to finish, running other jobs in the meantime.
+	 * 
+	 * @param job 
+	 */
+	void wait(const JobHandle& job);
+
+	/**
+	 * @brief Call a function on every index in [begin, end), split into chunks run in parallel. Returns once every index has been processed.
+	 * 
+	 * @tparam Function callable with a std::size_t.
+	 * @param begin 
+	 * @param end 
+	 * @param function 
+	 * @param grain chunks are a multiple of this many indices. Beyond that, chunks are sized so that every thread gets a few of them.
+	 */
+	template <typename Function>
+	void parallelFor(std::size_t begin, std::size_t end, Function&& function, std::size_t grain = 0);
+
+	/**
+	 * @brief Same as parallelFor(), but calls the function once per chunk rather than once per index. 
+	 * Chunks are contiguous, and each covers its range in order.
+	 * 
+	 * @tparam Function callable with the range of a chunk, as two std::size_t: its first index, and one past its last.
+	 * @param begin 
+	 * @param end 
+	 * @param function 
+	 * @param grain chunks are a multiple of this many indices, see parallelFor().
+	 */
+	template <typename Function>
+	void parallelForChunks(std::size_t begin, std::size_t end, Function&& function, std::size_t grain = 0);
+
+	/**
+	 * @return std::size_t the number of worker threads.
+	 */
+	std::size_t getWorkerCnt() const { return workers.size(); }
+
+	/**
+	 * @return unsigned int one less than the number of hardware threads.
+	 */
+	static unsigned int defaultWorkerCnt();
+private:
+	/**
+	 * @brief Jobs queued on a single thread.
+	 */
+	struct Queue {
+		std::mutex mutex;
+		std::deque<JobHandle> jobs;
+	};
+
+	std::vector<std::thread> workers;
+	std::vector<std::unique_ptr<Queue>> queues; //!< one per worker, then one for every thread outside of the pool.
+	std::atomic<std::size_t> queued = 0; //!< number of jobs sitting in queues.
+	std::atomic<bool> stopping = false;
+	std::mutex sleepMutex;
+	std::condition_variable wake; //!< signalled when a job is queued, or the pool stops.
+
+	/**
+	 * @brief Put a job whose dependencies are done into the queue of the calling thread, and wake a worker.
+	 * 
+	 * @param job 
+	 */
+	void enqueue(JobHandle job);
+
+	/**
+	 * @brief Take a job from the calling thread's queue, or steal one from another queue, and run it.
+	 * 
+	 * @return true if a job was run.
+	 * @return false if every queue was empty.
+	 */
+	bool runOne();
+
+	/**
+	 * @brief Run a job, then queue any continuation that was only waiting on it.
+	 * 
+	 * @param job 
+	 */
+	void execute(const JobHandle& job);
+
+	/**
+	 * @return std::size_t index of the calling thread's queue.
+	 */
+	std::size_t getQueueIndex() const;
+
+	/**
+	 * @brief Run jobs, sleeping while there are none, until the pool stops.
+	 * 
+	 * @param index the worker's index.
+	 */
+	void workerLoop(std::size_t index);
+};
+
+} // namespace Saga
+
+#include "jobSystem.inl"
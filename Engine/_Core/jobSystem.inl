@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include "jobSystem.h"
+
+namespace Saga {
+
+template <typename Function>
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, Function&& function, std::size_t grain) {
+	parallelForChunks(begin, end, [&function](std::size_t chunkBegin, std::size_t chunkEnd) {
+		for (std::size_t i = chunkBegin; i < chunkEnd; i++) function(i);
+	}, grain);
+}
+
+template <typename Function>
+void JobSystem::parallelForChunks(std::size_t begin, std::size_t end, Function&& function, std::size_t grain) {
+	if (begin >= end) return;
+	std::size_t count = end - begin;
+
+	// a few chunks per thread, so that threads finishing early can steal the rest
+	std::size_t threads = workers.size() + 1;
+	grain = std::max<std::size_t>(grain, 1);
+	std::size_t chunk = (count + threads * 4 - 1) / (threads * 4);
+	chunk = (chunk + grain - 1) / grain * grain;
+	if (!workers.size() || chunk >= count) {
+		function(begin, end);
+		return;
+	}
+
+	std::vector<JobHandle> chunks;
+	chunks.reserve((count + chunk - 1) / chunk);
+	// the calling thread takes the first chunk itself
+	for (std::size_t chunkBegin = begin + chunk; chunkBegin < end; chunkBegin += chunk) {
+		std::size_t chunkEnd = std::min(end, chunkBegin + chunk);
+		chunks.push_back(schedule([&function, chunkBegin, chunkEnd] { function(chunkBegin, chunkEnd); }));
+	}
+	function(begin, begin + chunk);
+	for (JobHandle& job : chunks) wait(job);
+}
+
+} // namespace Saga
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "Engine/Gameworld/componentContainer.h"
+
+/**
+ * Headless benchmark of ComponentContainer's sparse set against the pair of hash maps it replaced:
+ * emplacing, looking components up by entity, looking entities up by component, removing, and iterating.
+ *
+ * Usage: componentContainerBench [entityCnt], where entityCnt defaults to 50000.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	struct Position {
+		float x, y, z, w;
+	};
+
+	/**
+	 * @brief The storage ComponentContainer used before the sparse set: a vector of components,
+	 * with an unordered_map from entity to index and another from index back to entity.
+	 */
+	template <typename Component>
+	class MapContainer {
+	public:
+		Component* emplace(Saga::Entity entity, Component component) {
+			std::size_t index = components.size();
+			components.push_back(component);
+			componentMap[entity] = index;
+			entityMap[index] = entity;
+			return &components[index];
+		}
+
+		Component* getComponent(Saga::Entity entity) {
+			auto it = componentMap.find(entity);
+			return it == componentMap.end() ? nullptr : &components[it->second];
+		}
+
+		bool hasComponent(Saga::Entity entity) { return componentMap.count(entity); }
+
+		Saga::Entity getEntity(Component* component) {
+			auto it = std::find_if(components.begin(), components.end(), [&](Component& value) { return &value == component; });
+			return it == components.end() ? Saga::Entity(-1) : entityMap[it - components.begin()];
+		}
+
+		void removeComponent(Saga::Entity entity) {
+			auto it = componentMap.find(entity);
+			if (it == componentMap.end()) return;
+			std::size_t index = it->second, last = components.size() - 1;
+			Saga::Entity lastEntity = entityMap[last];
+			componentMap[lastEntity] = index;
+			entityMap[index] = lastEntity;
+			std::swap(components[index], components[last]);
+			components.pop_back();
+			componentMap.erase(entity);
+			entityMap.erase(last);
+		}
+
+		typename std::vector<Component>::iterator begin() { return components.begin(); }
+		typename std::vector<Component>::iterator end() { return components.end(); }
+
+	private:
+		std::vector<Component> components;
+		std::unordered_map<Saga::Entity, std::size_t> componentMap;
+		std::unordered_map<std::size_t, Saga::Entity> entityMap;
+	};
+
+	template <typename F>
+	double ms(F f) {
+		auto start = Clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	volatile float sink = 0;
+
+	// runs the same workload over either container and prints one line of timings
+	template <typename Container>
+	void run(const char* name, int entityCnt, const std::vector<int>& lookups) {
+		Container container;
+		double emplace = ms([&] { for (int i = 0; i < entityCnt; i++) container.emplace(Saga::Entity(i), Position{ 1, 2, 3, 4 }); });
+		double get = ms([&] { for (int i : lookups) if (Position* p = container.getComponent(Saga::Entity(i))) sink = sink + p->x; });
+		double has = ms([&] { int found = 0; for (int i : lookups) found += container.hasComponent(Saga::Entity(i)); sink = sink + found; });
+
+		std::vector<Position*> pointers;
+		for (int i = 0; i < 10000; i++) pointers.push_back(container.getComponent(Saga::Entity(lookups[i])));
+		double getEntity = ms([&] { for (Position* p : pointers) sink = sink + float(container.getEntity(p)); });
+
+		double remove = ms([&] { for (int i = 0; i < entityCnt; i += 2) container.removeComponent(Saga::Entity(i)); });
+		double iterate = ms([&] { for (int round = 0; round < 100; round++) for (Position& p : container) sink = sink + p.y; });
+
+		std::printf("%-12s | emplace %d %.2fms | getComponent %zu %.2fms | hasComponent %zu %.2fms | getEntity 10k %.2fms | remove %d %.2fms | iterate x100 %.2fms\n",
+			name, entityCnt, emplace, lookups.size(), get, lookups.size(), has, getEntity, entityCnt / 2, remove, iterate);
+	}
+}
+
+int main(int argc, char** argv) {
+	int entityCnt = argc > 1 ? std::atoi(argv[1]) : 50000;
+
+	std::mt19937 rng(1);
+	std::vector<int> lookups(2000000);
+	for (int& i : lookups) i = rng() % entityCnt;
+
+	run<MapContainer<Position>>("maps", entityCnt, lookups);
+	run<Saga::ComponentContainer<Position>>("sparse set", entityCnt, lookups);
+	return 0;
+}
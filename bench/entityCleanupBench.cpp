@@ -0,0 +1,83 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "Engine/Gameworld/gameworld.h"
+
+/**
+ * Headless benchmark of entityCleanup: destroying 10k entities in one frame, spread across worlds of different sizes.
+ * Each world has 30 component types, a few groups and some per-entity event listeners, while each entity only has 3 components,
+ * so the cost of touching every container, group and event for each destroyed entity shows up.
+ *
+ * Usage: entityCleanupBench
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	template <int N>
+	struct Component {
+		float values[4]{};
+	};
+
+	// exposes the end of the frame, which destroys entities
+	class BenchWorld : public Saga::GameWorld {
+	public:
+		void endOfFrame() { entityCleanup(); }
+	};
+
+	constexpr int componentTypeCnt = 30;
+	using Emplacer = void (*)(BenchWorld&, Saga::Entity);
+
+	// one function per component type, so that the type can be picked at runtime
+	template <int... N>
+	std::array<Emplacer, sizeof...(N)> makeEmplacers(std::integer_sequence<int, N...>) {
+		return { +[](BenchWorld& world, Saga::Entity entity) { world.emplace<Component<N>>(entity); }... };
+	}
+
+	// creates the container of each component type, even those no entity ends up having
+	template <int... N>
+	void createContainers(BenchWorld& world, std::integer_sequence<int, N...>) {
+		(world.viewAll<Component<N>>(), ...);
+	}
+
+	// microseconds of the entityCleanup that destroys 10k of entityCnt entities
+	double destroy10kUs(int entityCnt) {
+		auto world = std::make_shared<BenchWorld>();
+		createContainers(*world, std::make_integer_sequence<int, componentTypeCnt>{});
+		world->registerGroup<Component<0>, Component<1>>();
+		world->registerGroup<Component<0>, Component<2>>();
+		world->registerGroup<Component<3>, Component<4>>();
+		auto emplacers = makeEmplacers(std::make_integer_sequence<int, componentTypeCnt>{});
+
+		const int eventCnt = 8;
+		std::vector<Saga::Entity> entities;
+		for (int i = 0; i < entityCnt; i++) {
+			Saga::Entity entity = world->createEntity();
+			entities.push_back(entity);
+			emplacers[0](*world, entity);
+			emplacers[1 + i % 3](*world, entity);
+			emplacers[5 + i % 20](*world, entity);
+			if (i % 10 == 0) world->getSystems().addEventSystem(i % eventCnt, entity, Saga::RefSystem<Saga::Entity, int>([](Saga::WorldRef, Saga::Entity, int) {}));
+		}
+
+		const int step = entityCnt / 10000;
+		for (int i = 0; i < entityCnt; i += step) world->destroyEntity(entities[i]);
+
+		auto start = Clock::now();
+		world->endOfFrame();
+		return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+	}
+}
+
+int main() {
+	const int rounds = 5;
+	for (int entityCnt : { 10000, 100000 }) {
+		double total = 0;
+		for (int round = 0; round < rounds; round++) total += destroy10kUs(entityCnt);
+		std::printf("destroy 10k of %d entities: %.0fus\n", entityCnt, total / rounds);
+	}
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include "Engine/Datastructures/eventmap.h"
+
+/**
+ * Headless benchmark of event dispatch: broadcasting one event to many listeners, and delivering an event to each of many entities,
+ * through the typed channels of EventMap and EntityEventMap, and through the hash maps of type-erased callbacks they replaced.
+ *
+ * Usage: eventMapBench [listenerCnt], where listenerCnt defaults to 10000.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	struct World {};
+	using WorldPtr = std::shared_ptr<World>;
+
+	/**
+	 * @brief The dispatch EventMap used before typed channels: a hash map per event of shared callbacks,
+	 * each cast back to its real type with dynamic_pointer_cast when invoked.
+	 */
+	class HashEventMap {
+	public:
+		template <typename Event, typename ...DataType>
+		void addListener(Event event, std::shared_ptr<std::function<void(DataType...)>> listener) {
+			map[(int) event][++lastId] = std::make_shared<Callback<DataType...>>(listener);
+		}
+
+		template <typename Event, typename ...DataType>
+		void invoke(Event event, DataType... args) {
+			if (map.count((int) event))
+				for (auto& [id, callback] : map[(int) event])
+					std::dynamic_pointer_cast<Callback<DataType...>>(callback)->evoke(args...);
+		}
+
+	private:
+		struct ICallback {
+			virtual ~ICallback() = default;
+		};
+
+		template <typename ...DataType>
+		struct Callback : ICallback {
+			Callback(std::shared_ptr<std::function<void(DataType...)>> func) : func(func) {}
+			void evoke(DataType... args) { (*func)(args...); }
+			std::shared_ptr<std::function<void(DataType...)>> func;
+		};
+
+		std::unordered_map<int, std::unordered_map<std::uint64_t, std::shared_ptr<ICallback>>> map;
+		std::uint64_t lastId = 0;
+	};
+
+	long sink = 0;
+
+	// milliseconds per call of f, averaged over rounds
+	template <typename F>
+	double msPerRound(int rounds, F f) {
+		auto start = Clock::now();
+		for (int round = 0; round < rounds; round++) f(round);
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / rounds;
+	}
+}
+
+int main(int argc, char** argv) {
+	const int listenerCnt = argc > 1 ? std::atoi(argv[1]) : 10000;
+	const int rounds = 200;
+	const int broadcastEvent = 1, deliveredEvent = 2;
+	WorldPtr world = std::make_shared<World>();
+
+	// before: broadcast and per-entity listeners both live in hash maps of type-erased callbacks, keyed by entity for delivery
+	double hashBroadcast, hashDeliver;
+	{
+		HashEventMap broadcast;
+		std::unordered_map<int, HashEventMap> delivery;
+		for (int i = 0; i < listenerCnt; i++) {
+			broadcast.addListener(broadcastEvent, std::make_shared<std::function<void(WorldPtr, int)>>([](WorldPtr, int value) { sink += value; }));
+			delivery[deliveredEvent].addListener(i, std::make_shared<std::function<void(WorldPtr, Saga::Entity, int)>>(
+				[](WorldPtr, Saga::Entity entity, int value) { sink += value + long(entity); }));
+		}
+		hashBroadcast = msPerRound(rounds, [&](int round) { broadcast.invoke(broadcastEvent, world, round); });
+		hashDeliver = msPerRound(rounds, [&](int round) {
+			for (int i = 0; i < listenerCnt; i++) if (delivery.count(deliveredEvent)) delivery[deliveredEvent].invoke(i, world, Saga::Entity(i), round);
+		});
+	}
+
+	// now: typed channels, with per-entity listeners found through a sparse set
+	double channelBroadcast, channelDeliver;
+	{
+		Saga::EventMap broadcast;
+		std::unordered_map<int, Saga::EntityEventMap> delivery;
+		for (int i = 0; i < listenerCnt; i++) {
+			broadcast.addListener(broadcastEvent, std::function<void(WorldPtr, int)>([](WorldPtr, int value) { sink += value; }));
+			delivery[deliveredEvent].addListener(Saga::Entity(i), std::function<void(WorldPtr, Saga::Entity, int)>(
+				[](WorldPtr, Saga::Entity entity, int value) { sink += value + long(entity); }));
+		}
+		channelBroadcast = msPerRound(rounds, [&](int round) { broadcast.invoke(broadcastEvent, world, round); });
+		channelDeliver = msPerRound(rounds, [&](int round) {
+			for (int i = 0; i < listenerCnt; i++) {
+				auto it = delivery.find(deliveredEvent);
+				if (it != delivery.end()) it->second.invoke(Saga::Entity(i), world, Saga::Entity(i), round);
+			}
+		});
+	}
+
+	std::printf("%d listeners | broadcast: hash maps %.3fms, channels %.3fms | deliver to each entity: hash maps %.3fms, channels %.3fms (%ld)\n",
+		listenerCnt, hashBroadcast, channelBroadcast, hashDeliver, channelDeliver, sink);
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "Engine/_Core/jobSystem.h"
+
+/**
+ * Headless benchmark of the JobSystem: how many empty jobs it gets through per second, 
+ * how long a job waits between being scheduled and starting, and how long parallelFor takes over a large array.
+ * 
+ * Usage: jobSystemBench [workerCnt], where workerCnt defaults to JobSystem::defaultWorkerCnt().
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	double jobsPerSecond(Saga::JobSystem& jobs, int jobCnt) {
+		std::atomic<int> ran = 0;
+		std::vector<Saga::JobHandle> handles;
+		handles.reserve(jobCnt);
+
+		auto start = Clock::now();
+		for (int i = 0; i < jobCnt; i++) handles.push_back(jobs.schedule([&ran] { ran.fetch_add(1, std::memory_order_relaxed); }));
+		for (Saga::JobHandle& handle : handles) jobs.wait(handle);
+		return jobCnt / std::chrono::duration<double>(Clock::now() - start).count();
+	}
+
+	// microseconds between scheduling each job and it starting, sorted
+	std::vector<double> startLatencies(Saga::JobSystem& jobs, int jobCnt) {
+		std::vector<double> latencies;
+		latencies.reserve(jobCnt);
+		for (int i = 0; i < jobCnt; i++) {
+			Clock::time_point started;
+			auto scheduled = Clock::now();
+			jobs.wait(jobs.schedule([&started] { started = Clock::now(); }));
+			latencies.push_back(std::chrono::duration<double, std::micro>(started - scheduled).count());
+		}
+		std::sort(latencies.begin(), latencies.end());
+		return latencies;
+	}
+
+	// milliseconds per parallelFor over the array, averaged over a few rounds
+	double parallelForMs(Saga::JobSystem& jobs, std::vector<float>& values, int rounds) {
+		auto start = Clock::now();
+		for (int round = 0; round < rounds; round++)
+			jobs.parallelFor(0, values.size(), [&values](std::size_t i) { values[i] = values[i] * 1.0001f + 0.5f; });
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / rounds;
+	}
+}
+
+int main(int argc, char** argv) {
+	unsigned int workerCnt = argc > 1 ? std::atoi(argv[1]) : Saga::JobSystem::defaultWorkerCnt();
+	Saga::JobSystem jobs(workerCnt);
+
+	double throughput = jobsPerSecond(jobs, 200000);
+	std::vector<double> latencies = startLatencies(jobs, 2000);
+	std::vector<float> values(1 << 22, 1.0f);
+	double parallelFor = parallelForMs(jobs, values, 10);
+
+	std::printf("workers %u | throughput %.2f M jobs/s | schedule->start latency p50 %.1fus p99 %.1fus | parallelFor %zu floats %.2fms\n",
+		workerCnt, throughput / 1e6, latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], values.size(), parallelFor);
+	return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "Engine/Gameworld/componentContainer.h"
+
+/**
+ * Headless benchmark of spawn throughput: emplacing a light and a heavy component for many entities.
+ * It compares ComponentContainer, which constructs components in place from forwarded arguments,
+ * with the emplace it replaced, which default-constructed every slot when growing and copied a temporary into it.
+ *
+ * Usage: spawnBench [entityCnt], where entityCnt defaults to 100000.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	struct Light {
+		float x, y, z;
+	};
+
+	// owns memory, like Mesh or ParticleCollection
+	struct Heavy {
+		std::vector<float> data;
+		std::string name;
+	};
+
+	/**
+	 * @brief The emplace ComponentContainer used before: the vector grows through resize, default-constructing the new slots,
+	 * and each component is built as a temporary from copies of the arguments, then copy-assigned into its slot.
+	 */
+	template <typename Component>
+	class ResizingContainer {
+	public:
+		template <typename... Args>
+		Component* emplace(Saga::Entity, Args&&... args) {
+			std::size_t index = cnt++;
+			if (index >= components.size()) components.resize(cnt * 2);
+			const Component component(args...);
+			components[index] = component;
+			return &components[index];
+		}
+
+	private:
+		std::vector<Component> components;
+		std::size_t cnt = 0;
+	};
+
+	template <typename F>
+	double ms(F f) {
+		auto start = Clock::now();
+		f();
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	// runs the same spawn workload a few times over fresh containers and prints the average timings
+	template <template <typename> typename Container>
+	void run(const char* name, int entityCnt) {
+		const int rounds = 5;
+		double light = 0, heavy = 0;
+		for (int round = 0; round < rounds; round++) {
+			Container<Light> lights;
+			Container<Heavy> heavies;
+			light += ms([&] { for (int i = 0; i < entityCnt; i++) lights.emplace(Saga::Entity(i), Light{ 1, 2, 3 }); });
+			heavy += ms([&] { for (int i = 0; i < entityCnt; i++) heavies.emplace(Saga::Entity(i), Heavy{ std::vector<float>(64, 1.f), "a fairly long component name" }); });
+		}
+		std::printf("%-10s | spawn %d light %.2fms, heavy %.2fms\n", name, entityCnt, light / rounds, heavy / rounds);
+	}
+}
+
+int main(int argc, char** argv) {
+	int entityCnt = argc > 1 ? std::atoi(argv[1]) : 100000;
+	run<ResizingContainer>("resize", entityCnt);
+	run<Saga::ComponentContainer>("in place", entityCnt);
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include "Engine/Gameworld/gameworld.h"
+
+/**
+ * Headless benchmark of what it costs to call a System: the same empty staged and event systems,
+ * registered once as a System, which receives a shared_ptr to the world, and once as a RefSystem, which receives a WorldRef.
+ *
+ * Usage: worldRefBench
+ */
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	// exposes running the update stage, which the Application normally does
+	class BenchWorld : public Saga::GameWorld {
+	public:
+		void update() { systemManager.runStageUpdate(*this, 0.f, 0.f); }
+	};
+
+	long sink = 0;
+
+	// nanoseconds per call of f
+	template <typename F>
+	double nsPerCall(int calls, F f) {
+		auto start = Clock::now();
+		for (int i = 0; i < calls; i++) f(i);
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / calls;
+	}
+
+	// nanoseconds per staged system, with systemCnt copies of the system registered
+	template <typename SystemType>
+	double stagedSystemNs(SystemType system, int systemCnt) {
+		auto world = std::make_shared<BenchWorld>();
+		for (int i = 0; i < systemCnt; i++) world->getSystems().addStagedSystem(system);
+		return nsPerCall(20000, [&](int) { world->update(); }) / systemCnt;
+	}
+
+	// nanoseconds per broadcast event, with a single listener
+	template <typename SystemType>
+	double eventSystemNs(SystemType system) {
+		auto world = std::make_shared<BenchWorld>();
+		world->getSystems().addEventSystem(1, system);
+		return nsPerCall(2000000, [&](int i) { world->broadcastEvent(1, i); });
+	}
+}
+
+int main() {
+	const int systemCnt = 100;
+	double stagedShared = stagedSystemNs(Saga::System<float, float>([](std::shared_ptr<Saga::GameWorld>, float, float) { sink++; }), systemCnt);
+	double stagedRef = stagedSystemNs(Saga::RefSystem<float, float>([](Saga::WorldRef, float, float) { sink++; }), systemCnt);
+	double eventShared = eventSystemNs(Saga::System<int>([](std::shared_ptr<Saga::GameWorld>, int value) { sink += value; }));
+	double eventRef = eventSystemNs(Saga::RefSystem<int>([](Saga::WorldRef, int value) { sink += value; }));
+
+	std::printf("staged system: System %.1fns, RefSystem %.1fns | broadcast event: System %.1fns, RefSystem %.1fns (%ld)\n",
+		stagedShared, stagedRef, eventShared, eventRef, sink);
+	return 0;
+}
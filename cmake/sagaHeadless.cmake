@@ -0,0 +1,27 @@
+#The parts of the engine that run without a window, OpenGL or FMOD: the ECS, its Systems bookkeeping, and the JobSystem.
+#Shared by bench/ and tests/, which can be built on their own or from the main project.
+include_guard(GLOBAL)
+
+set(SAGA_ROOT_DIR "${CMAKE_CURRENT_LIST_DIR}/..")
+
+set(CMAKE_CXX_STANDARD 20)
+set(CMAKE_CXX_STANDARD_REQUIRED ON)
+
+find_package(Threads REQUIRED)
+
+file(GLOB sagaGameworldSources CONFIGURE_DEPENDS "${SAGA_ROOT_DIR}/Engine/Gameworld/*.cpp")
+
+add_library(SagaHeadless STATIC
+    ${sagaGameworldSources}
+    ${SAGA_ROOT_DIR}/Engine/_Core/logger.cpp
+    ${SAGA_ROOT_DIR}/Engine/_Core/jobSystem.cpp
+    ${SAGA_ROOT_DIR}/Engine/Datastructures/sparseSet.cpp
+    ${SAGA_ROOT_DIR}/Engine/Systems/systemAccess.cpp
+    ${SAGA_ROOT_DIR}/Engine/Systems/systemManager.cpp
+    ${SAGA_ROOT_DIR}/Engine/Systems/invokableSystemManager.cpp
+)
+target_include_directories(SagaHeadless PUBLIC
+    ${SAGA_ROOT_DIR}
+    ${SAGA_ROOT_DIR}/External/plog/include
+)
+target_link_libraries(SagaHeadless PUBLIC Threads::Threads)
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "Engine/Gameworld/gameworld.h"
+
+/**
+ * Headless test of the CommandBuffer: entities spawned and destroyed through it recycle the world's slots, 
+ * so a steady stream of short-lived entities, like particles, does not grow the world.
+ */
+
+#define CHECK(expr) do { if (!(expr)) { std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); return 1; } } while (0)
+
+namespace {
+	struct Lifetime {
+		int framesLeft;
+	};
+
+	// exposes the end of the frame, which plays the buffer back and destroys entities
+	class TestWorld : public Saga::GameWorld {
+	public:
+		void endOfFrame() { entityCleanup(); }
+	};
+
+	int spawnAndDestroyKeepsSlotsBounded() {
+		auto world = std::make_shared<TestWorld>();
+		const int spawnedPerFrame = 200;
+		const int lifetime = 3;
+
+		std::vector<Saga::Entity> live;
+		Saga::entity_type highestIndex = 0;
+		Saga::entity_type highestIndexWhenSteady = 0;
+		for (int frame = 0; frame < 5000; frame++) {
+			Saga::CommandBuffer& commands = world->getCommands();
+			for (int i = 0; i < spawnedPerFrame; i++) {
+				Saga::Entity entity = commands.createEntity();
+				commands.emplace<Lifetime>(entity, Lifetime{ lifetime });
+				highestIndex = std::max(highestIndex, Saga::getEntityIndex(entity));
+				live.push_back(entity);
+			}
+			if (live.size() > spawnedPerFrame * lifetime) {
+				for (int i = 0; i < spawnedPerFrame; i++) commands.destroyEntity(live[i]);
+				live.erase(live.begin(), live.begin() + spawnedPerFrame);
+			}
+			world->endOfFrame();
+
+			for (Saga::Entity entity : live) CHECK(world->isAlive(entity) && world->hasComponent<Lifetime>(entity));
+			// once as many entities die as are spawned every frame, freed slots are all that is needed
+			if (frame == lifetime + 1) highestIndexWhenSteady = highestIndex;
+			if (frame > lifetime + 1) CHECK(highestIndex == highestIndexWhenSteady);
+		}
+		return 0;
+	}
+
+	int bufferAndWorldDoNotShareSlots() {
+		auto world = std::make_shared<TestWorld>();
+		Saga::Entity destroyed = world->createEntity();
+		world->destroyEntity(destroyed);
+		world->endOfFrame();
+
+		// the buffer reserves the freed slot, so the world has to pick another one
+		Saga::Entity fromBuffer = world->getCommands().createEntity();
+		Saga::Entity fromWorld = world->createEntity();
+		CHECK(Saga::getEntityIndex(fromBuffer) == Saga::getEntityIndex(destroyed));
+		CHECK(Saga::getEntityIndex(fromBuffer) != Saga::getEntityIndex(fromWorld));
+		CHECK(!world->isAlive(destroyed));
+
+		world->endOfFrame();
+		CHECK(world->isAlive(fromBuffer) && world->isAlive(fromWorld));
+		return 0;
+	}
+}
+
+int main() {
+	if (spawnAndDestroyKeepsSlotsBounded()) return 1;
+	if (bufferAndWorldDoNotShareSlots()) return 1;
+	std::printf("commandBuffer: ok\n");
+	return 0;
+}